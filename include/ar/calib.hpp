@@ -14,14 +14,30 @@ namespace ar {
 struct Calibration {
   cv::Mat cameraMatrix;   //!< Matrice intrinsèque 3x3 (CV_64F)
   cv::Mat distCoeffs;     //!< Coefficients de distorsion (1xN, CV_64F)
+  cv::Size imageSize;     //!< Résolution pour laquelle cameraMatrix est valide
 };
 
 /**
  * @brief Charge la calibration depuis un fichier YAML OpenCV.
+ *
+ * La résolution native est lue dans image_width / image_height ; si elle est
+ * absente, imageSize reste vide et scaleCalibration() renvoie K inchangée.
  * @param filename Chemin du fichier (ex: ../data/camera.yaml)
  * @return Calibration (cameraMatrix + distCoeffs)
  * @throws std::runtime_error si le fichier est invalide
  */
 Calibration loadCalibration(const std::string& filename);
 
+/**
+ * @brief Met la calibration à l'échelle d'une autre résolution (capture,
+ * niveau de pyramide du détecteur...).
+ *
+ * fx, cx sont multipliés par size.width / imageSize.width (idem en y), en
+ * convention centre de pixel ; la distorsion, exprimée en coordonnées
+ * normalisées, est inchangée. Suppose le même champ de vue (pas de recadrage).
+ * @param calib Calibration dont imageSize est renseignée
+ * @param size Résolution cible
+ */
+Calibration scaleCalibration(const Calibration& calib, cv::Size size);
+
 } // namespace ar
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <opencv2/core.hpp>
+#include "ar/calib.hpp"
+
+/**
+ * @file calibcache.hpp
+ * @brief Cache binaire de calibration : démarrage sans analyse YAML ni calcul des LUT.
+ *
+ * Le cache est écrit à côté du YAML (`<yaml>.<w>x<h>.arcal`) et relu par une
+ * seule projection mmap. Il est invalidé si le YAML change (date de
+ * modification, taille, empreinte du contenu), si la résolution diffère, si
+ * la version du format change ou si la somme de contrôle est fausse : il est
+ * alors reconstruit depuis le YAML. Un répertoire en lecture seule n'est pas
+ * une erreur (le cache n'est simplement pas écrit).
+ *
+ * Disposition : CalibCacheHeader (128 octets) | K (9 doubles) | distorsion
+ * (distCount doubles) | coefficients NDC (4 doubles) | LUT map1 (CV_16SC2) |
+ * LUT map2 (CV_16UC1), chaque bloc aligné sur 64 octets.
+ */
+namespace ar {
+
+constexpr std::uint32_t CALIB_CACHE_VERSION = 3;   // 3 : plus de taille native déduite de (cx, cy)
+constexpr std::uint32_t CALIB_CACHE_HAS_LUT = 1u;
+
+/// En-tête du fichier cache.
+struct CalibCacheHeader {
+  char magic[8];              //!< "ARCALIB1"
+  std::uint32_t version;      //!< CALIB_CACHE_VERSION
+  std::uint32_t flags;        //!< CALIB_CACHE_HAS_LUT
+  std::int64_t yamlMtime;     //!< Date de modification du YAML (ns)
+  std::uint64_t yamlSize;
+  std::uint64_t yamlHash;     //!< FNV-1a du contenu du YAML
+  std::int32_t width, height; //!< Résolution de la clé (K est stockée à cette échelle)
+  std::int32_t nativeWidth, nativeHeight; //!< Résolution de la calibration d'origine
+  std::uint32_t distCount;
+  std::uint32_t reserved0;
+  std::uint64_t checksum;     //!< Somme de contrôle de tout ce qui suit l'en-tête
+  std::uint8_t reserved[56];
+};
+
+/**
+ * @brief Calibration prête à l'emploi pour une résolution donnée.
+ */
+struct PreparedCalibration {
+  Calibration calib;           //!< Mise à l'échelle de imageSize (cf. scaleCalibration)
+  cv::Size nativeSize;         //!< Résolution du YAML d'origine
+  cv::Size imageSize;          //!< Résolution pour laquelle calib, ndc et les LUT sont valides
+  cv::Vec4d ndc;               //!< (2fx/w, 2fy/h, 1-2cx/w, 2cy/h-1), cf. projectionFromNDC
+  cv::Mat undistMap1;          //!< LUT initUndistortRectifyMap (CV_16SC2), vide si non demandée
+  cv::Mat undistMap2;          //!< LUT d'interpolation (CV_16UC1)
+  bool fromCache = false;      //!< true si chargée depuis le cache
+  std::shared_ptr<void> mapping; //!< Garde la projection mmap en vie (LUT sans copie)
+};
+
+/**
+ * @brief Charge la calibration depuis le cache binaire, ou depuis le YAML
+ * (puis écrit le cache) si celui-ci est absent ou périmé.
+ * @param yamlPath Calibration OpenCV (cf. loadCalibration)
+ * @param imageSize Résolution effective de la source
+ * @param withUndistort Calcule / charge aussi les LUT de correction de distorsion
+ * @throws std::runtime_error si le YAML est invalide
+ */
+PreparedCalibration loadCalibrationCached(const std::string& yamlPath, cv::Size imageSize,
+                                          bool withUndistort = false);
+
+} // namespace ar
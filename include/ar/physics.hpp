@@ -7,6 +7,17 @@
 
 namespace ar {
 
+/// Épaisseur des murs du cadre A4 (mm).
+constexpr float A4_WALL_THICKNESS = 10.0f;
+
+/**
+ * @brief Murs du cadre autour de la feuille A4 (x1, y1, x2, y2 en mm, repère feuille).
+ *
+ * Assemblage "menuisier" : les murs verticaux sont longs et couvrent les
+ * coins, les horizontaux s'insèrent entre eux.
+ */
+std::vector<std::array<float, 4>> a4FrameWalls();
+
 void resolveWallCollision(glm::vec3& pos, glm::vec3& vel, float radius, 
                           float x1, float y1, float x2, float y2);
 
@@ -19,6 +19,15 @@ namespace ar {
  */
 glm::mat4 projectionFromCV(const cv::Mat& K, float w, float h, float n, float f);
 
+/**
+ * @brief Projection OpenGL à partir des coefficients normalisés précalculés
+ * (cf. PreparedCalibration::ndc), indépendants de la taille du viewport.
+ * @param ndc (2fx/w, 2fy/h, 1-2cx/w, 2cy/h-1) pour l'image de calibration
+ * @param n Plan proche (>0)
+ * @param f Plan lointain (>n)
+ */
+glm::mat4 projectionFromNDC(const cv::Vec4d& ndc, float n, float f);
+
 /**
  * @brief Construit une View matrix OpenGL (column-major) depuis rvec/tvec OpenCV.
  * @param rvec Vecteur de rotation 3x1 (CV_64F) – Rodrigues
@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <iosfwd>
+#include <vector>
+
+/**
+ * @file quality.hpp
+ * @brief Contrôleur de qualité pour tenir un budget de temps par image.
+ *
+ * Chaque étape (vision, physique, rendu) a une échelle de niveaux, du plus
+ * fidèle au moins coûteux :
+ * - vision : réduction de la luminance de détection (1, 1/2, 1/4) et
+ *   fréquence de détection (les autres images sont suivies par flux optique) ;
+ * - physique : nombre de sous-pas par image ;
+ * - rendu : plafond de l'échelle de la couche 3D (cf. glx::ResolutionController).
+ *
+ * Au-dessus du budget, on dégrade l'étape la plus chère ; largement en
+ * dessous, on restaure d'abord la dernière étape dégradée. Hystérésis : le
+ * dépassement doit durer, la marge doit durer plus longtemps encore, et une
+ * pause suit chaque décision. Chaque décision est journalisée.
+ */
+namespace ar {
+
+enum class Stage { Vision = 0, Physics, Render, Count };
+
+/// Réglages courants, lus par la boucle principale.
+struct QualitySettings {
+  int detectDenom = 1;          //!< Luminance de détection à 1/detectDenom
+  int detectInterval = 1;       //!< Détection complète une image sur N (suivi seul sinon)
+  int physicsSubsteps = 4;      //!< Sous-pas de updatePhysics par image
+  float renderScaleMax = 1.0f;  //!< Plafond de l'échelle de la couche 3D
+};
+
+class QualityController {
+public:
+  /// @param targetFps <= 0 : contrôleur inactif (qualité maximale)
+  /// @param log Journal des décisions (nullptr : silencieux)
+  explicit QualityController(double targetFps, std::ostream* log = nullptr);
+
+  /// Durée d'une étape pour l'image courante (cumulée si appelée plusieurs fois).
+  void record(Stage stage, double ms);
+  /// Clôt l'image ; true si les réglages ont changé.
+  bool endFrame();
+
+  const QualitySettings& settings() const { return settings_; }
+  double budgetMs() const { return budgetMs_; }
+  double averageMs(Stage stage) const { return avg_[(int)stage]; }
+  double averageFrameMs() const;
+
+private:
+  void apply();
+  void logDecision(const char* what, Stage stage);
+
+  double budgetMs_;
+  std::ostream* log_;
+  std::array<double, (int)Stage::Count> cur_{};   //!< Image en cours
+  std::array<double, (int)Stage::Count> avg_{};   //!< Moyennes glissantes
+  std::array<int, (int)Stage::Count> level_{};    //!< 0 = meilleure qualité
+  std::vector<Stage> degraded_;                   //!< Pile des dégradations
+  QualitySettings settings_;
+  long frames_ = 0;
+  int overFrames_ = 0, calmFrames_ = 0, cooldown_ = 0;
+};
+
+} // namespace ar
@@ -0,0 +1,117 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include <glm/glm.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ar/calibcache.hpp"
+#include "ar/workpool.hpp"
+#include "detect/a4.hpp"
+#include "detect/motion.hpp"
+#include "io/capture.hpp"
+
+/**
+ * @file stream.hpp
+ * @brief Un flux du serveur multi-caméras : capture, vision, pose et physique.
+ *
+ * Chaque flux a son propre thread de capture (LatestFrameGrabber), son
+ * détecteur / suivi A4, sa porte de mouvement, sa pose et son monde physique.
+ * La vision puis la physique d'une image sont deux tâches du pool partagé,
+ * la seconde soumise par la première ; un flux n'a jamais plus d'une image en
+ * cours, les images arrivées entre-temps sont remplacées par la plus récente.
+ */
+namespace ar {
+
+/// Statistiques d'un flux sur une fenêtre (cf. StreamProcessor::takeStats).
+struct StreamStats {
+  double seconds = 0;        //!< Durée de la fenêtre
+  std::uint64_t frames = 0;  //!< Images traitées
+  std::uint64_t detected = 0;//!< Dont feuille trouvée
+  std::uint64_t gated = 0;   //!< Dont scène fixe (détection sautée)
+  std::uint64_t dropped = 0; //!< Images de la source jamais traitées
+  double latencySumMs = 0;   //!< Capture -> fin de la physique
+  double latencyMaxMs = 0;
+  double visionSumMs = 0;
+  double physicsSumMs = 0;
+
+  double fps() const { return seconds > 0 ? frames / seconds : 0.0; }
+};
+
+class StreamProcessor {
+public:
+  /**
+   * @param name Nom affiché dans les statistiques
+   * @param source Source d'images (lue par le thread de capture du flux)
+   * @param calibPath Calibration YAML (cache binaire par résolution)
+   */
+  StreamProcessor(std::string name, std::unique_ptr<io::FrameSource> source, std::string calibPath);
+  ~StreamProcessor();
+
+  StreamProcessor(const StreamProcessor&) = delete;
+  StreamProcessor& operator=(const StreamProcessor&) = delete;
+
+  /**
+   * @brief Lit la première image (taille -> calibration) et démarre la capture.
+   * @throws std::runtime_error si la source est vide ou la calibration invalide
+   */
+  void start(WorkStealingPool& pool);
+
+  /// Arrête la capture et attend la fin de l'image en cours.
+  void stop();
+
+  /// true quand la source est épuisée et la dernière image traitée.
+  bool finished() const;
+
+  /// Statistiques depuis l'appel précédent (remises à zéro).
+  StreamStats takeStats();
+
+  const std::string& name() const { return name_; }
+  cv::Size imageSize() const { return prepared_.imageSize; }
+
+private:
+  void onFrame();        // thread de capture
+  void visionTask();     // pool
+  void physicsTask();    // pool, soumise par visionTask
+  void endCycle();
+
+  std::string name_;
+  std::unique_ptr<io::FrameSource> source_;
+  std::string calibPath_;
+  std::unique_ptr<io::LatestFrameGrabber> grabber_;
+  WorkStealingPool* pool_ = nullptr;
+  PreparedCalibration prepared_;
+
+  // Une image en cours au plus : busy_ réservé par onFrame, pending_ = image arrivée pendant le cycle
+  std::atomic<bool> busy_{false}, pending_{false}, stopping_{false};
+  mutable std::mutex idleM_;
+  std::condition_variable idleCv_;
+
+  // État du cycle (touché par une seule tâche à la fois)
+  io::Frame frame_;
+  cv::Mat gray_;
+  detect::A4Tracker tracker_;
+  detect::MotionGate gate_;
+  std::vector<cv::Point2f> corners_;
+  bool found_ = false;
+  cv::Mat rvec_, tvec_;
+  double lastTimestamp_ = 0;
+  double visionMs_ = 0;
+
+  // Monde physique du flux
+  std::vector<std::array<float, 4>> walls_;
+  glm::vec3 ballPos_{0.f, 0.f, 8.f}, ballVel_{0.f};
+  glm::mat4 ballRotation_{1.0f};
+
+  // Statistiques de la fenêtre courante
+  mutable std::mutex statsM_;
+  StreamStats stats_;
+  double windowStart_ = 0;
+  std::uint64_t droppedBase_ = 0;
+};
+
+} // namespace ar
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file workpool.hpp
+ * @brief Pool de threads à vol de tâches, partagé par tous les flux du serveur.
+ *
+ * Chaque worker a sa propre file. Une tâche soumise depuis un worker (suite
+ * d'une tâche : physique après vision) va dans la file de ce worker et est
+ * reprise en dernier entré, premier sorti (données encore en cache). Une
+ * tâche soumise de l'extérieur (thread de capture) est répartie à tour de
+ * rôle. Un worker sans travail vole la tâche la plus ancienne d'un autre
+ * avant de s'endormir.
+ */
+namespace ar {
+
+/// Compteurs du pool.
+struct WorkPoolStats {
+  std::uint64_t executed = 0;  //!< Tâches exécutées
+  std::uint64_t stolen = 0;    //!< Dont volées à un autre worker
+};
+
+class WorkStealingPool {
+public:
+  /// @param threads Nombre de workers (0 : un par cœur)
+  explicit WorkStealingPool(unsigned threads = 0);
+
+  /// Arrête les workers ; les tâches encore en file sont abandonnées.
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  /// Ajoute une tâche (appelable depuis n'importe quel thread, y compris une tâche).
+  void submit(std::function<void()> task);
+
+  unsigned size() const { return (unsigned)queues_.size(); }
+
+  WorkPoolStats stats() const;
+
+private:
+  struct Queue {
+    std::mutex m;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool popLocal(unsigned self, std::function<void()>& task);
+  bool steal(unsigned self, std::function<void()>& task);
+  void run(unsigned self);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<std::size_t> pending_{0};   //!< Tâches en file (toutes files confondues)
+  std::atomic<unsigned> nextQueue_{0};
+  std::atomic<bool> stop_{false};
+  std::mutex sleepM_;
+  std::condition_variable sleepCv_;
+  std::atomic<std::uint64_t> executed_{0}, stolen_{0};
+};
+
+} // namespace ar
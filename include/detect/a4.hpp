@@ -1,5 +1,6 @@
 #pragma once
 #include <opencv2/core.hpp>
+#include "detect/bitmask.hpp"
 #include <vector>
 
 /**
@@ -33,8 +34,8 @@ bool orderFourCorners(const std::vector<cv::Point>& approx,
  *
  * Pipeline de détection :
  * - Conversion en niveaux de gris + floutage
- * - Seuillage dynamique basé sur la moyenne d'une ROI centrale
- * - Recherche de contours
+ * - Seuillage dynamique basé sur la moyenne d'une ROI centrale (masque 1 bit, cf. bitmask.hpp)
+ * - Étiquetage des composantes et contour de la plus grande seulement (cf. blob.hpp)
  * - Sélection du plus grand quadrilatère
  * - Ordonnancement TL/TR/BR/BL
  *
@@ -45,6 +46,59 @@ bool orderFourCorners(const std::vector<cv::Point>& approx,
 bool detectA4Corners(const cv::Mat& frameBGR,
                      std::vector<cv::Point2f>& imagePts);
 
+/**
+ * @brief Variante de detectA4Corners travaillant directement sur la luminance.
+ *
+ * Évite la conversion BGR -> gris quand la source fournit déjà un plan Y
+ * (V4L2 YUYV/NV12, décodage MJPEG réduit).
+ *
+ * @param luma Image CV_8UC1 (un pas de ligne quelconque est accepté).
+ * @param[out] imagePts 4 points en coordonnées pleine résolution.
+ * @param denom luma est à 1/denom de la pleine résolution (1 = même taille).
+ */
+bool detectA4CornersLuma(const cv::Mat& luma,
+                         std::vector<cv::Point2f>& imagePts,
+                         int denom = 1);
+
+/**
+ * @brief Détecteur A4 avec suivi temporel des coins.
+ *
+ * Mémorise les coins de la frame précédente pour garder un ordre stable
+ * (TL/BL/BR/TR) et maintient la dernière position quelques frames en cas de
+ * perte (anti-clignotement). Une instance par flux vidéo ; les fonctions
+ * libres detectA4Corners / detectA4CornersLuma utilisent une instance partagée.
+ */
+class A4Tracker {
+public:
+  /// Détection sur image BGR (conversion en gris puis detectLuma).
+  bool detect(const cv::Mat& frameBGR, std::vector<cv::Point2f>& imagePts);
+
+  /// Détection sur luminance, éventuellement réduite 1/denom.
+  bool detectLuma(const cv::Mat& luma, std::vector<cv::Point2f>& imagePts, int denom = 1);
+
+  /**
+   * @brief Suivi seul (sans détection) : flux optique Lucas-Kanade des 4 coins
+   * de prevLuma à luma. Beaucoup moins cher que detectLuma ; échoue si un coin
+   * est perdu ou si le quadrilatère dégénère (il faut alors redétecter).
+   * @param prevLuma, luma Luminances de même taille, à 1/denom de la pleine résolution
+   * @param[out] imagePts Coins en coordonnées pleine résolution
+   */
+  bool track(const cv::Mat& prevLuma, const cv::Mat& luma, std::vector<cv::Point2f>& imagePts, int denom = 1);
+
+  /// Oublie le suivi (prochaine détection = tri géométrique).
+  void reset();
+
+  bool isTracking() const { return hasTracking_; }
+
+private:
+  bool holdPrevious(std::vector<cv::Point2f>& imagePts);
+
+  std::vector<cv::Point2f> prevCorners_;
+  bool hasTracking_ = false;
+  int lostFramesCount_ = 0;
+  BitMask mask_;   //!< Masque seuillé, réutilisé d'une frame à l'autre
+};
+
 /**
  * @brief Dessine les 4 coins ordonnés sur une image avec des couleurs et labels.
  *
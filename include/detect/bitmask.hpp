@@ -0,0 +1,62 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file bitmask.hpp
+ * @brief Masque binaire à 1 bit par pixel et morphologie rectangulaire par mots.
+ *
+ * Chaque ligne occupe wordsPerRow() mots de 64 bits, le bit de poids faible
+ * du premier mot étant le pixel x = 0 ; les bits au-delà de la largeur sont
+ * toujours nuls. Dilatation et érosion sont séparables : passe horizontale par
+ * décalages avec report entre mots voisins, passe verticale par OU / ET de
+ * lignes entières, 64 pixels par opération. Les bords suivent OpenCV (hors
+ * image : 0 pour la dilatation, 1 pour l'érosion).
+ */
+namespace detect {
+
+class BitMask {
+public:
+  BitMask() = default;
+  BitMask(int width, int height) { create(width, height); }
+
+  /// Redimensionne (sans réallouer si la taille ne change pas) ; contenu indéfini.
+  void create(int width, int height);
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  int wordsPerRow() const { return words_; }
+  bool empty() const { return bits_.empty(); }
+
+  std::uint64_t* row(int y) { return bits_.data() + (std::size_t)y * words_; }
+  const std::uint64_t* row(int y) const { return bits_.data() + (std::size_t)y * words_; }
+
+  bool get(int x, int y) const { return (row(y)[x >> 6] >> (x & 63)) & 1u; }
+
+  /// Masque du dernier mot d'une ligne (bits valides).
+  std::uint64_t lastWordMask() const {
+    return (width_ & 63) ? (~0ull >> (64 - (width_ & 63))) : ~0ull;
+  }
+
+  /// Copie 8 bits (0 / 255), pour le débogage et la comparaison avec OpenCV.
+  cv::Mat toMat() const;
+
+private:
+  int width_ = 0, height_ = 0, words_ = 0;
+  std::vector<std::uint64_t> bits_;
+};
+
+/// Seuillage direct en bits : pixel allumé si src > thresh (comme THRESH_BINARY).
+void thresholdToBits(const cv::Mat& src, double thresh, BitMask& dst);
+
+/// Dilatation par un rectangle ksize, ancre au centre (dst peut être src).
+void dilateRect(const BitMask& src, BitMask& dst, cv::Size ksize);
+
+/// Érosion par un rectangle ksize, ancre au centre (dst peut être src).
+void erodeRect(const BitMask& src, BitMask& dst, cv::Size ksize);
+
+/// Fermeture (dilatation puis érosion), cf. morphologyEx(MORPH_CLOSE).
+void closeRect(const BitMask& src, BitMask& dst, cv::Size ksize);
+
+} // namespace detect
@@ -0,0 +1,45 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include "detect/bitmask.hpp"
+#include <vector>
+
+/**
+ * @file blob.hpp
+ * @brief Plus grande composante d'un masque binaire, sans passer par findContours.
+ *
+ * Un seul balayage étiquette les segments horizontaux de pixels allumés
+ * (union-find, 8-connexité) en cumulant au vol l'aire, la boîte englobante et
+ * le premier pixel de chaque composante ; seule la composante gagnante est
+ * ensuite détourée (suivi de bord de Moore). Les autres taches ne produisent
+ * ni contour ni allocation par point.
+ */
+namespace detect {
+
+/// Statistiques d'une composante connexe.
+struct BlobStats {
+  double area = 0;    //!< Nombre de pixels (les trous ne comptent pas)
+  cv::Rect bbox;      //!< Boîte englobante
+  cv::Point start;    //!< Premier pixel dans l'ordre de balayage (sur le bord extérieur)
+};
+
+/**
+ * @brief Contour extérieur de la plus grande composante 8-connexe du masque.
+ *
+ * Équivalent de findContours(RETR_EXTERNAL, CHAIN_APPROX_SIMPLE) restreint à
+ * la composante la plus grande : le contour est parcouru dans le sens horaire
+ * (image, y vers le bas) et seuls les changements de direction sont gardés.
+ *
+ * @param mask Masque CV_8UC1 (pixel allumé = valeur non nulle)
+ * @param minArea La composante doit compter strictement plus de minArea pixels
+ * @param[out] contour Contour extérieur de la composante
+ * @param[out] stats Statistiques de la composante (optionnel)
+ * @return false si aucune composante ne dépasse minArea
+ */
+bool largestBlobContour(const cv::Mat& mask, double minArea,
+                        std::vector<cv::Point>& contour, BlobStats* stats = nullptr);
+
+/// Variante sur masque 1 bit : segments trouvés 64 pixels à la fois.
+bool largestBlobContour(const BitMask& mask, double minArea,
+                        std::vector<cv::Point>& contour, BlobStats* stats = nullptr);
+
+} // namespace detect
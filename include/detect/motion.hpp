@@ -0,0 +1,55 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @file motion.hpp
+ * @brief Détecteur de changement bon marché pour sauter la détection sur scène fixe.
+ *
+ * L'image est réduite en une vignette 64x36, découpée en blocs de 8x4 pixels.
+ * On compare (somme des différences absolues, SSE2 si disponible) la vignette
+ * courante à celle de la dernière image réellement traitée, uniquement sur les
+ * blocs qui recouvrent le quadrilatère suivi et sa marge (toute l'image s'il
+ * n'y a pas de quadrilatère). Si aucun bloc n'a changé, les coins et la pose
+ * précédents restent valables. Un rafraîchissement est forcé toutes les
+ * refreshInterval images pour borner la dérive lente (éclairage, exposition).
+ */
+namespace detect {
+
+struct MotionGateConfig {
+  int refreshInterval = 30;   //!< Images réutilisées au plus d'affilée (<= 0 : porte désactivée)
+  double threshold = 3.0;     //!< Écart moyen toléré par bloc (niveaux de gris)
+  float margin = 0.15f;       //!< Marge autour du quadrilatère (fraction de sa taille)
+};
+
+class MotionGate {
+public:
+  static constexpr int THUMB_W = 64, THUMB_H = 36;
+  static constexpr int BLOCK_W = 8, BLOCK_H = 4;
+
+  explicit MotionGate(MotionGateConfig cfg = {}) : cfg_(cfg) {}
+
+  /**
+   * @brief Indique si le résultat précédent peut être réutilisé.
+   *
+   * Si ce n'est pas le cas, l'image courante devient la référence : l'appelant
+   * doit alors refaire détection et pose.
+   * @param luma Luminance CV_8UC1 à 1/denom de la pleine résolution
+   * @param quad Coins du dernier résultat (pleine résolution), vide si aucun
+   */
+  bool isStatic(const cv::Mat& luma, int denom, const std::vector<cv::Point2f>& quad);
+
+  /// Oublie la référence (la prochaine image sera traitée).
+  void reset();
+
+  long skippedFrames() const { return skipped_; }
+  long totalFrames() const { return total_; }
+
+private:
+  MotionGateConfig cfg_;
+  cv::Mat thumb_, ref_;
+  int reused_ = 0;   //!< Images réutilisées depuis la référence
+  long skipped_ = 0, total_ = 0;
+};
+
+} // namespace detect
@@ -0,0 +1,48 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "glx/resource.hpp"
+
+/**
+ * @file ballbatch.hpp
+ * @brief Instances des balles pour le rendu en imposteurs.
+ *
+ * Chaque balle est un quad (4 sommets, GL_TRIANGLE_STRIP) étendu dans
+ * BALL_IMPOSTOR_VS à partir de gl_VertexID ; la sphère est lancée de rayons
+ * dans le fragment shader (profondeur exacte via gl_FragDepth). Les mêmes
+ * instances servent aux ombres analytiques (BLOB_SHADOW_VS) : le travail par
+ * balle ne dépend plus de la tessellation.
+ */
+namespace glx {
+
+/// Attributs d'instance (locations 0..4).
+struct BallInstance {
+  float center[3];      //!< Centre (repère monde)
+  float radius;
+  float rotation[9];    //!< Orientation (mat3, colonnes) : repère balle -> monde
+};
+
+class BallBatch {
+public:
+  /// Nécessite un contexte GL courant.
+  BallBatch();
+
+  void clear() { balls_.clear(); }
+  /// @param rotation Seule la partie 3x3 est utilisée
+  void add(const glm::vec3& center, float radius, const glm::mat4& rotation);
+  /// Envoie les instances au GPU ; à appeler avant les draws.
+  void upload();
+
+  GLuint vao() const { return vao_.get(); }
+  /// Nombre d'instances (glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, n)).
+  GLsizei count() const { return (GLsizei)balls_.size(); }
+
+private:
+  std::vector<BallInstance> balls_;
+  std::size_t capacity_ = 0;
+  VertexArrayHandle vao_;
+  BufferHandle vbo_;
+};
+
+} // namespace glx
@@ -0,0 +1,90 @@
+#pragma once
+#include <GL/glew.h>
+#include "glx/resource.hpp"
+
+/**
+ * @file dynres.hpp
+ * @brief Résolution dynamique de la couche 3D : rendu hors écran à une
+ * échelle réglée par un contrôleur de budget, puis composition sur le fond
+ * caméra à pleine résolution.
+ *
+ * Le temps GPU de la couche est mesuré par requêtes GL_TIME_ELAPSED lues
+ * avec une image de retard (pas de synchronisation CPU/GPU).
+ */
+namespace glx {
+
+/**
+ * @brief FBO couleur RGBA8 (alpha prémultiplié) + profondeur 24 bits.
+ */
+class OffscreenTarget {
+public:
+  /// (Ré)alloue les attachements si la taille change ; nécessite un contexte GL.
+  /// @throws std::runtime_error si le FBO est incomplet
+  void resize(int width, int height);
+  /// Lie le FBO et règle le viewport sur sa taille.
+  void bind() const;
+
+  GLuint colorTexture() const { return color_.get(); }
+  int width() const { return w_; }
+  int height() const { return h_; }
+
+private:
+  int w_ = 0, h_ = 0;
+  FramebufferHandle fbo_;
+  TextureHandle color_, depth_;
+};
+
+/**
+ * @brief Chronomètre GPU à deux requêtes alternées.
+ */
+class GpuTimer {
+public:
+  GpuTimer();
+  ~GpuTimer();
+  GpuTimer(const GpuTimer&) = delete;
+  GpuTimer& operator=(const GpuTimer&) = delete;
+
+  void begin();
+  void end();
+  /// Résultat de la mesure précédente s'il est disponible (sans attente).
+  bool poll(double& ms);
+
+private:
+  GLuint q_[2] = {0, 0};
+  bool pending_[2] = {false, false};
+  int cur_ = 0;
+};
+
+/**
+ * @brief Échelle de rendu pour tenir un budget de temps (ms).
+ *
+ * Moyenne glissante du temps mesuré ; descente immédiate quand le budget est
+ * dépassé de 10 % (le coût suit le nombre de pixels, soit l'échelle au
+ * carré), remontée d'un cran seulement après une série d'images sous 70 % du
+ * budget. Échelle quantifiée par pas de 1/16 : le FBO n'est pas réalloué à
+ * chaque image.
+ */
+class ResolutionController {
+public:
+  /// @param budgetMs Budget de la couche ; <= 0 : échelle fixe à maxScale
+  explicit ResolutionController(double budgetMs, float minScale = 0.5f, float maxScale = 1.0f);
+
+  /// Intègre une mesure ; true si l'échelle a changé.
+  bool update(double ms);
+
+  float scale() const { return scale_; }
+  double averageMs() const { return avgMs_; }
+  double budgetMs() const { return budgetMs_; }
+  /// Borne l'échelle (cf. contrôleur global de qualité).
+  void setMaxScale(float s);
+
+private:
+  double budgetMs_;
+  float minScale_, maxScale_;
+  float scale_;
+  double avgMs_ = 0.0;
+  int cooldown_ = 0;      //!< Images à attendre après un changement
+  int calmFrames_ = 0;    //!< Images consécutives largement sous le budget
+};
+
+} // namespace glx
@@ -0,0 +1,57 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "glx/resource.hpp"
+
+/**
+ * @file linebatch.hpp
+ * @brief Lignes épaisses de débogage (axes, contour A4, arêtes des murs,
+ * trajectoires) en un seul draw instancié, sans geometry shader.
+ *
+ * Chaque segment est une instance (LineSegment) ; LINE_INST_VS l'étend en un
+ * quad écran de 4 sommets à partir de gl_VertexID. Les segments ajoutés avant
+ * markStatic() restent dans le tampon d'une image à l'autre ; seuls les
+ * suivants (dynamiques) sont renvoyés au GPU à chaque upload().
+ */
+namespace glx {
+
+/// Attributs d'instance (locations 0..3 de LINE_INST_VS).
+struct LineSegment {
+  float a[3], b[3];     //!< Extrémités (repère monde)
+  float color[3];
+  float thicknessPx;    //!< Demi-largeur en pixels (convention de LINE_GS)
+};
+
+class LineBatch {
+public:
+  /// Nécessite un contexte GL courant.
+  LineBatch();
+
+  void add(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color, float thicknessPx);
+  /// Ligne brisée ; closed relie le dernier point au premier.
+  void addPolyline(const std::vector<glm::vec3>& pts, bool closed, const glm::vec3& color, float thicknessPx);
+  /// Paires de points (p0,p1), (p2,p3)... (cf. WallMesh::edgePoints).
+  void addPairs(const std::vector<glm::vec3>& pts, const glm::vec3& color, float thicknessPx);
+
+  /// Les segments déjà ajoutés deviennent statiques (conservés par clear()).
+  void markStatic();
+  /// Retire les segments dynamiques.
+  void clear();
+  /// Envoie au GPU ce qui a changé ; à appeler avant le draw.
+  void upload();
+
+  GLuint vao() const { return vao_.get(); }
+  /// Nombre d'instances à dessiner (glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, n)).
+  GLsizei count() const { return (GLsizei)segments_.size(); }
+
+private:
+  std::vector<LineSegment> segments_;
+  std::size_t staticCount_ = 0;
+  std::size_t uploadedStatic_ = 0;   //!< Segments statiques déjà sur le GPU
+  std::size_t capacity_ = 0;         //!< Capacité du VBO (segments)
+  VertexArrayHandle vao_;
+  BufferHandle vbo_;
+};
+
+} // namespace glx
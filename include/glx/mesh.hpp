@@ -18,12 +18,27 @@ struct Mesh {
   GLsizei count = 0;///< Nombre de sommets / indices
 };
 
+// Format des maillages éclairés (variante LIT de MESH_VS) :
+// position (loc 0), UV (loc 1), normale (loc 2) entrelacées
+struct LitVertex { float px, py, pz, u, v, nx, ny, nz; };
+
+// Déclare le format LitVertex sur le VAO et le VBO actuellement liés
+void setLitVertexLayout();
+
+// Matrice des normales (uNormalMatrix) : inverse transposée, calculée une fois par objet
+inline glm::mat3 normalMatrix(const glm::mat4& model) {
+  return glm::transpose(glm::inverse(glm::mat3(model)));
+}
+
 // Regroupe trois Mesh pour les axes x/y/z
 struct Axes { Mesh x, y, z; };
 
 // Quad plein-écran (pour fond ou post-process)
 Mesh createBackgroundQuad();
 
+// Sol : rectangle dans le plan z = 0 centré à l'origine, normale +Z (format LitVertex)
+Mesh createFloorQuad(float halfWidth, float halfHeight);
+
 // Cube en mode fil de fer
 Mesh createCubeWireframe(float size);
 
@@ -32,7 +47,38 @@ Axes createAxes(float L);
 
 // Mur vertical entre (x1,y1) et (x2,y2) avec une certaine hauteur
 Mesh createWall(float x1, float y1, float x2, float y2, float height, float thickness);
-Mesh createWalls(const std::vector<std::array<float,4>>& segments, float height, float thickness);
 Mesh createSphere(float radius, int slices, int stacks);
-Mesh createWallsWireframe(const std::vector<std::array<float,4>>& segments, float height, float thickness);
+
+// Plage d'indices dans un EBO partagé
+struct IndexRange {
+  GLsizei count = 0;    ///< Nombre d'indices
+  GLintptr offset = 0;  ///< Décalage en octets dans l'EBO (pour glDrawElements)
+};
+
+// Murs en un seul maillage : faces dans le VBO/EBO, contours côté CPU
+struct WallMesh {
+  Mesh mesh;                             ///< VAO/VBO/EBO (mesh.count = indices des faces)
+  GLenum indexType = GL_UNSIGNED_SHORT;  ///< GL_UNSIGNED_SHORT si < 65536 sommets, sinon GL_UNSIGNED_INT
+  IndexRange triangles;                  ///< Faces (GL_TRIANGLES)
+  GLsizei vertexCount = 0;
+  std::vector<glm::vec3> edgePoints;     ///< Contours par paires, dessinés via LineBatch
+};
+
+/**
+ * @brief Murs (labyrinthe) en un seul VBO au format LitVertex.
+ *
+ * Chaque face a ses propres sommets (normale par face, éclairage plat) :
+ * 16 à 20 LitVertex de 32 octets par mur, contre 8 positions de 12 octets
+ * dans chacun des deux anciens maillages (plein et fil de fer). La mémoire
+ * des sommets augmente donc ; le gain est un seul upload, un seul VAO,
+ * des indices 16 bits et l'absence des faces de bout cachées.
+ *
+ * Jonctions : une extrémité de mur qui touche un autre mur (coin en L, en T,
+ * assemblage "menuisier") n'a pas de face de bout, celle-ci étant cachée.
+ * La recherche des voisins passe par une grille spatiale : linéaire en
+ * nombre de segments, utilisable pour des milliers de murs.
+ * @param mergeEps Tolérance (mm) pour considérer qu'une extrémité touche un mur
+ */
+WallMesh createWallMesh(const std::vector<std::array<float,4>>& segments,
+                        float height, float thickness, float mergeEps = 0.01f);
 } // namespace glx
@@ -0,0 +1,74 @@
+#pragma once
+#include <GL/glew.h>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include "glx/mesh.hpp"
+#include "glx/resource.hpp"
+
+/**
+ * @file meshcache.hpp
+ * @brief Cache de maillages partagés et niveaux de détail (LOD) de la sphère.
+ */
+namespace glx {
+
+/**
+ * @brief Cache de maillages indexé par (forme, paramètres).
+ *
+ * Deux demandes identiques renvoient le même Mesh (mêmes VAO/VBO/EBO) :
+ * plusieurs balles de même rayon ne créent qu'un jeu de tampons. Le cache
+ * est propriétaire des tampons (MeshHandle), libérés par clear() ou à sa destruction.
+ */
+class MeshCache {
+public:
+  using Params = std::array<float, 4>;
+
+  MeshCache() = default;
+  MeshCache(const MeshCache&) = delete;
+  MeshCache& operator=(const MeshCache&) = delete;
+
+  /// Maillage (shape, params), construit par build() au premier appel.
+  const Mesh& get(const std::string& shape, const Params& params, const std::function<Mesh()>& build);
+
+  /// Sphère UV avec normales (cf. createSphere), partagée.
+  const Mesh& sphere(float radius, int slices, int stacks);
+
+  /// Libère tous les tampons GL.
+  void clear();
+
+  std::size_t size() const { return meshes_.size(); }
+
+private:
+  std::map<std::pair<std::string, Params>, MeshHandle> meshes_;
+};
+
+/**
+ * @brief Chaîne de LOD d'une sphère : 8 / 16 / 32 / 64 tranches.
+ *
+ * Le niveau est choisi d'après la taille projetée de la sphère : on prend le
+ * moins détaillé dont les arêtes de l'équateur restent sous maxEdgePx pixels.
+ */
+struct SphereLOD {
+  static constexpr int LEVELS = 4;
+  static constexpr std::array<int, LEVELS> SLICES = {8, 16, 32, 64};
+
+  float radius = 1.f;
+  std::array<const Mesh*, LEVELS> levels{};
+
+  /**
+   * @param distance Distance caméra -> centre (mêmes unités que radius)
+   * @param focalPx Focale en pixels (fy de la calibration)
+   * @param maxEdgePx Longueur d'arête visée à l'écran
+   * @return Indice du niveau (0 = le plus grossier)
+   */
+  int select(float distance, float focalPx, float maxEdgePx = 6.f) const;
+
+  const Mesh& mesh(int level) const { return *levels[level]; }
+};
+
+/// Crée (ou reprend depuis le cache) les 4 niveaux pour ce rayon.
+SphereLOD createSphereLOD(MeshCache& cache, float radius);
+
+} // namespace glx
@@ -0,0 +1,101 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file renderqueue.hpp
+ * @brief File de rendu : les passes soumettent des DrawItem, triés par état
+ * puis exécutés en ne changeant programme / VAO / texture / états fixes que
+ * lorsque c'est nécessaire.
+ *
+ * Ordre : par couche (Background < Opaque < Transparent), puis, pour les
+ * couches opaques, par état (états fixes, programme, texture, VAO). La couche
+ * transparente garde l'ordre de soumission (mélange non commutatif).
+ */
+namespace glx {
+
+enum class Layer : std::uint8_t { Background = 0, Opaque = 1, Transparent = 2 };
+
+/// États fixes d'un draw.
+struct DrawState {
+  bool depthTest = true;
+  bool blend = false;          //!< Couleur : GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA ; alpha : GL_ONE,
+                               //!< GL_ONE_MINUS_SRC_ALPHA (cible hors écran en alpha prémultiplié)
+  bool polygonOffset = false;  //!< glPolygonOffset(1, 1) sur les faces pleines
+
+  std::uint8_t bits() const { return (std::uint8_t)(depthTest | (blend << 1) | (polygonOffset << 2)); }
+};
+
+/// Valeur d'uniform stockée dans le DrawItem (pas d'allocation).
+struct UniformValue {
+  enum Type : std::uint8_t { Int, Float, Vec2, Vec3, Vec4, Mat3, Mat4 };
+  GLint location = -1;
+  Type type = Float;
+  float v[16];
+};
+
+/**
+ * @brief Un appel de dessin et tout l'état dont il dépend.
+ */
+struct DrawItem {
+  static constexpr int MAX_UNIFORMS = 8;
+
+  Layer layer = Layer::Opaque;
+  DrawState state;
+  GLuint program = 0;
+  GLuint vao = 0;
+  GLuint texture = 0;            //!< Texture 2D sur l'unité 0 (0 = aucune)
+  GLenum mode = GL_TRIANGLES;
+  GLsizei count = 0;
+  GLenum indexType = 0;          //!< 0 : glDrawArrays, sinon glDrawElements
+  GLintptr indexOffset = 0;      //!< Décalage en octets dans l'EBO
+  GLsizei instances = 0;         //!< 0 : draw simple, sinon draw instancié
+
+  std::array<UniformValue, MAX_UNIFORMS> uniforms;
+  int uniformCount = 0;
+
+  DrawItem& setTexture(GLuint tex) { texture = tex; return *this; }
+  DrawItem& setPolygonOffset(bool on) { state.polygonOffset = on; return *this; }
+  DrawItem& setInstances(GLsizei n) { instances = n; return *this; }
+
+  DrawItem& set(GLint loc, int v);
+  DrawItem& set(GLint loc, float v);
+  DrawItem& set(GLint loc, const glm::vec2& v);
+  DrawItem& set(GLint loc, const glm::vec3& v);
+  DrawItem& set(GLint loc, const glm::vec4& v);
+  DrawItem& set(GLint loc, const glm::mat3& m);
+  DrawItem& set(GLint loc, const glm::mat4& m);
+};
+
+/**
+ * @brief File réutilisée d'une image à l'autre (clear() garde la capacité).
+ */
+class RenderQueue {
+public:
+  void clear() { items_.clear(); }
+
+  /// glDrawArrays(mode, 0, count)
+  DrawItem& drawArrays(Layer layer, GLuint program, GLuint vao, GLenum mode, GLsizei count);
+  /// glDrawElements(mode, count, indexType, offset)
+  DrawItem& drawElements(Layer layer, GLuint program, GLuint vao, GLenum mode, GLsizei count,
+                         GLenum indexType, GLintptr offset = 0);
+
+  /// Trie et exécute les couches [from, to] ; laisse le VAO 0 lié.
+  void execute(Layer from = Layer::Background, Layer to = Layer::Transparent);
+
+  /// Changements d'état effectués lors du dernier execute() (diagnostic).
+  struct Stats { int draws = 0, programBinds = 0, vaoBinds = 0, textureBinds = 0, stateChanges = 0; };
+  const Stats& stats() const { return stats_; }
+
+private:
+  struct Entry { std::uint64_t key; std::uint32_t index; };
+
+  std::vector<DrawItem> items_;
+  std::vector<Entry> order_;
+  Stats stats_;
+};
+
+} // namespace glx
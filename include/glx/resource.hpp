@@ -0,0 +1,131 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <utility>
+#include "glx/mesh.hpp"
+
+/**
+ * @file resource.hpp
+ * @brief Poignées RAII (déplaçables, non copiables) pour les objets OpenGL
+ * et registre des ressources vivantes.
+ *
+ * Chaque poignée s'inscrit dans le registre à l'adoption (taille mesurée
+ * auprès du driver) et s'en retire à la destruction : le registre donne la
+ * mémoire GPU vivante et signale les fuites à la fermeture.
+ *
+ * Les poignées doivent être détruites avant le contexte GL : les déclarer
+ * après la fenêtre (cf. GlfwWindowGuard dans main.cpp).
+ */
+namespace glx {
+
+enum class GpuKind { Buffer = 0, VertexArray, Texture, Program, Framebuffer, Count };
+
+/// Bilan des ressources vivantes.
+struct GpuStats {
+  std::size_t count[(int)GpuKind::Count] = {};
+  std::size_t bufferBytes = 0;
+  std::size_t textureBytes = 0;   //!< Estimation (niveau 0 + mipmaps)
+};
+
+/**
+ * @brief Registre (thread-safe) des objets GL vivants.
+ */
+class ResourceRegistry {
+public:
+  static ResourceRegistry& instance();
+
+  void add(GpuKind kind, GLuint id, std::size_t bytes);
+  void update(GpuKind kind, GLuint id, std::size_t bytes);
+  void remove(GpuKind kind, GLuint id);
+
+  GpuStats stats() const;
+  /// Une ligne : nombre d'objets par type et mémoire.
+  void report(std::ostream& os) const;
+
+private:
+  ResourceRegistry() = default;
+  mutable std::mutex m_;
+  std::map<std::pair<int, GLuint>, std::size_t> live_;
+};
+
+/// Taille (octets) d'un objet GL, interrogée auprès du driver.
+std::size_t measureGpuObject(GpuKind kind, GLuint id);
+/// Destruction de l'objet GL.
+void destroyGpuObject(GpuKind kind, GLuint id);
+
+/**
+ * @brief Poignée RAII sur un objet GL d'un type donné.
+ */
+template <GpuKind K>
+class GlHandle {
+public:
+  GlHandle() = default;
+  explicit GlHandle(GLuint id) { reset(id); }
+  ~GlHandle() { reset(); }
+
+  GlHandle(const GlHandle&) = delete;
+  GlHandle& operator=(const GlHandle&) = delete;
+  GlHandle(GlHandle&& o) noexcept : id_(std::exchange(o.id_, 0)) {}
+  GlHandle& operator=(GlHandle&& o) noexcept {
+    if (this != &o) { reset(); id_ = std::exchange(o.id_, 0); }
+    return *this;
+  }
+
+  /// Libère l'objet courant et adopte id (0 = vide).
+  void reset(GLuint id = 0) {
+    if (id_) {
+      ResourceRegistry::instance().remove(K, id_);
+      destroyGpuObject(K, id_);
+    }
+    id_ = id;
+    if (id_) ResourceRegistry::instance().add(K, id_, measureGpuObject(K, id_));
+  }
+
+  /// Abandonne la propriété sans détruire.
+  GLuint release() {
+    if (id_) ResourceRegistry::instance().remove(K, id_);
+    return std::exchange(id_, 0);
+  }
+
+  /// Remesure après réallocation (glBufferData, glTexImage2D...).
+  void remeasure() { if (id_) ResourceRegistry::instance().update(K, id_, measureGpuObject(K, id_)); }
+
+  GLuint get() const { return id_; }
+  explicit operator bool() const { return id_ != 0; }
+
+private:
+  GLuint id_ = 0;
+};
+
+using BufferHandle      = GlHandle<GpuKind::Buffer>;
+using VertexArrayHandle = GlHandle<GpuKind::VertexArray>;
+using TextureHandle     = GlHandle<GpuKind::Texture>;
+using ProgramHandle     = GlHandle<GpuKind::Program>;
+using FramebufferHandle = GlHandle<GpuKind::Framebuffer>;
+
+/**
+ * @brief Propriétaire d'un Mesh (VAO + VBO + EBO) ; l'accès au Mesh reste
+ * celui des fonctions createXxx.
+ */
+class MeshHandle {
+public:
+  MeshHandle() = default;
+  explicit MeshHandle(const Mesh& m) : mesh_(m), vao_(m.vao), vbo_(m.vbo), ebo_(m.ebo) {}
+
+  MeshHandle(MeshHandle&&) noexcept = default;
+  MeshHandle& operator=(MeshHandle&&) noexcept = default;
+
+  const Mesh& get() const { return mesh_; }
+  const Mesh* operator->() const { return &mesh_; }
+
+private:
+  Mesh mesh_;
+  // Ordre de destruction : tampons puis VAO
+  VertexArrayHandle vao_;
+  BufferHandle vbo_, ebo_;
+};
+
+} // namespace glx
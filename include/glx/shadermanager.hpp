@@ -0,0 +1,64 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file shadermanager.hpp
+ * @brief Construction des programmes GLSL par variantes (#define) avec cache
+ * disque des binaires liés (glGetProgramBinary).
+ *
+ * Une variante = une source + un masque de #define injectés après la ligne
+ * #version. Le binaire lié est écrit dans `<cacheDir>/<clé>.glbin`, la clé
+ * étant l'empreinte du driver (GL_VENDOR, GL_RENDERER, GL_VERSION) et des
+ * sources après injection : un changement de driver ou de shader produit une
+ * autre clé. Un binaire refusé par le driver, tronqué ou corrompu est
+ * recompilé puis réécrit ; un répertoire non inscriptible n'est pas une erreur.
+ */
+namespace glx {
+
+/// Variantes (masque de bits) ; le nom du #define injecté suit entre parenthèses.
+enum ShaderVariant : unsigned {
+  VARIANT_TEXTURED     = 1u << 0,  //!< (TEXTURED) texture sur l'unité 0, UV en location 1
+  VARIANT_LIT          = 1u << 1,  //!< (LIT) Blinn-Phong, normales en location 2
+  VARIANT_INSTANCED    = 1u << 2,  //!< (INSTANCED) matrice modèle par instance en locations 3..6 (+ normales 7..9 si LIT)
+  VARIANT_VERTEX_COLOR = 1u << 3,  //!< (VERTEX_COLOR) couleur par sommet en location 1
+};
+
+/// Sources d'un programme (gs optionnel).
+struct ProgramSource {
+  const char* vs = nullptr;
+  const char* gs = nullptr;
+  const char* fs = nullptr;
+};
+
+/// Répertoire par défaut : $XDG_CACHE_HOME/ar-a4/shaders, sinon ~/.cache/ar-a4/shaders.
+std::string defaultShaderCacheDir();
+
+/**
+ * @brief Construit les programmes (depuis le cache si possible).
+ * Nécessite un contexte GL courant.
+ */
+class ShaderManager {
+public:
+  /// @param cacheDir Répertoire du cache ; vide = pas de cache disque
+  explicit ShaderManager(std::string cacheDir = defaultShaderCacheDir());
+
+  /**
+   * @brief Programme lié pour une variante ; l'appelant en est propriétaire
+   * (cf. ProgramHandle).
+   * @throws std::runtime_error si la compilation ou l'édition de liens échoue
+   */
+  GLuint build(const ProgramSource& src, unsigned variants = 0);
+
+  struct Stats { int cacheHits = 0, compiled = 0; double ms = 0.0; };
+  const Stats& stats() const { return stats_; }
+
+private:
+  std::string cacheDir_;
+  std::string driver_;   //!< GL_VENDOR | GL_RENDERER | GL_VERSION
+  bool binarySupported_ = false;
+  Stats stats_;
+};
+
+} // namespace glx
@@ -11,45 +11,24 @@ namespace glx {
 GLuint compile(GLenum type, const char* src);
 GLuint link(const std::vector<GLuint>& shaders);
 
-// Shaders source (BG, LINES + GS) – fournis comme littéraux
+// Shaders source – fournis comme littéraux. Les blocs #ifdef sont activés
+// par ShaderManager (cf. shadermanager.hpp) ; compilés tels quels, ils donnent
+// la variante de base.
 extern const char* const BG_VS;
 extern const char* const BG_FS;
-extern const char* const LINE_VS;
+extern const char* const LINE_VS;   //!< Variante VERTEX_COLOR : couleur par sommet (location 1)
 extern const char* const LINE_GS;
 extern const char* const LINE_FS;
-extern const char* const SOLID_VS;
-extern const char* const SOLID_FS;
-
-static const char* WALL_VS = R"(#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aUV;
-
-uniform mat4 uMVP;
-out vec2 vUV;
-
-void main() {
-    vUV = aUV;
-    gl_Position = uMVP * vec4(aPos, 1.0);
-}
-)";
-
-static const char* WALL_FS = R"(#version 330 core
-in vec2 vUV;
-out vec4 FragColor;
-
-uniform sampler2D uWallTex;
-
-void main() {
-    FragColor = texture(uWallTex, vUV);
-}
-)";
-extern const char* const TEX_OBJ_VS;
-extern const char* const TEX_OBJ_FS;
-
-// Eclairage & Ombres ---
-extern const char* const PHONG_VS;
-extern const char* const PHONG_FS;
-
-extern const char* const SHADOW_VS;
-extern const char* const SHADOW_FS;
+extern const char* const LINE_INST_VS; //!< Lignes instanciées (cf. LineBatch), avec LINE_FS
+
+// Maillages : couleur unie (uColor vec4) ; variantes TEXTURED, LIT (Blinn-Phong,
+// format LitVertex, uNormalMatrix fournie par le CPU), INSTANCED
+extern const char* const MESH_VS;
+extern const char* const MESH_FS;
+
+// Balles en imposteurs (un quad par balle) et ombres analytiques ; instances BallBatch
+extern const char* const BALL_IMPOSTOR_VS;
+extern const char* const BALL_IMPOSTOR_FS;
+extern const char* const BLOB_SHADOW_VS;
+extern const char* const BLOB_SHADOW_FS;
 } // namespace glx 
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * @file capture.hpp
+ * @brief Capture vidéo sur un thread dédié avec sémantique "la dernière image gagne".
+ *
+ * Pour une source live (webcam, flux téléphone), lire les images dans l'ordre
+ * fait croître la latence dès que le traitement prend du retard : le tampon
+ * V4L2 / réseau se remplit. Le grabber lit en continu dans un triple tampon
+ * et ne rend au consommateur que l'image la plus récente (les autres sont
+ * comptées comme abandonnées).
+ */
+namespace io {
+
+/**
+ * @brief Format natif des pixels fournis par la source.
+ */
+enum class PixelFormat {
+  BGR,   //!< Image déjà en BGR (cv::VideoCapture, décodeur MJPEG)
+  YUYV,  //!< YUV 4:2:2 entrelacé (Y0 U Y1 V), dans Frame::yuv (CV_8UC2)
+  NV12   //!< YUV 4:2:0 semi-planaire, dans Frame::yuv (CV_8UC1, h*3/2 lignes)
+};
+
+/**
+ * @brief Image capturée et ses métadonnées.
+ */
+struct Frame {
+  cv::Mat bgr;              //!< Image couleur (BGR, 8 bits) ; vide si format != BGR (voir ensureBGR)
+  cv::Mat yuv;              //!< Image native YUYV / NV12 (vue sur le tampon driver)
+  PixelFormat format = PixelFormat::BGR;
+  cv::Mat luma;             //!< Luminance pour la détection (CV_8UC1), vide si non fournie
+  int lumaDenom = 1;        //!< luma est à 1/lumaDenom de la résolution de l'image
+  std::uint64_t seq = 0;    //!< Numéro de séquence attribué par la source (1, 2, ...)
+  double timestamp = 0.0;   //!< Instant de capture (s, horloge monotone ; noyau pour V4L2)
+  std::shared_ptr<void> owner; //!< Garde le tampon driver (mmap) en vie tant que l'image est utilisée
+
+  /// Taille de l'image pleine résolution, quel que soit le format.
+  cv::Size size() const;
+};
+
+/**
+ * @brief Convertit l'image (BGR, YUYV ou NV12) en RGBA pour la texture OpenGL.
+ */
+void toRGBA(const Frame& frame, cv::Mat& rgba);
+
+/**
+ * @brief Garantit que frame.bgr est rempli (conversion depuis yuv si besoin).
+ *
+ * À n'appeler qu'une fois par image : la conversion n'est pas mémorisée.
+ */
+const cv::Mat& ensureBGR(Frame& frame);
+
+/**
+ * @brief Source d'images abstraite (cv::VideoCapture, backend natif, fichier...).
+ */
+class FrameSource {
+public:
+  virtual ~FrameSource() = default;
+
+  /**
+   * @brief Lit l'image suivante (bloquant).
+   * @param[in,out] out Image de destination ; ses tampons sont réutilisés si possible.
+   * @return false en fin de flux ou en cas d'erreur.
+   */
+  virtual bool read(Frame& out) = 0;
+};
+
+/**
+ * @brief Adaptateur FrameSource autour d'un cv::VideoCapture déjà ouvert.
+ */
+class VideoCaptureSource : public FrameSource {
+public:
+  explicit VideoCaptureSource(cv::VideoCapture& cap) : cap_(cap) {}
+  bool read(Frame& out) override;
+
+private:
+  cv::VideoCapture& cap_;
+  std::uint64_t seq_ = 0;
+};
+
+/**
+ * @brief Compteurs du grabber.
+ */
+struct GrabberStats {
+  std::uint64_t captured  = 0; //!< Images lues depuis la source
+  std::uint64_t delivered = 0; //!< Images rendues au consommateur
+  std::uint64_t dropped   = 0; //!< Images écrasées avant d'avoir été consommées
+};
+
+/**
+ * @brief Thread de capture + triple tampon "latest-frame-wins".
+ *
+ * Les trois tampons sont : celui en cours de remplissage (thread de capture),
+ * celui publié en attente, et celui détenu par le consommateur. La remise
+ * d'une image est un simple échange de cv::Mat (pas de copie de pixels) ;
+ * l'ancienne image du consommateur repart dans le cycle et sera réécrite,
+ * il ne faut donc pas en garder d'en-tête cv::Mat partagé d'un appel à l'autre.
+ */
+class LatestFrameGrabber {
+public:
+  explicit LatestFrameGrabber(FrameSource& src) : src_(src) {}
+  ~LatestFrameGrabber() { stop(); }
+
+  LatestFrameGrabber(const LatestFrameGrabber&) = delete;
+  LatestFrameGrabber& operator=(const LatestFrameGrabber&) = delete;
+
+  /**
+   * @brief Rappel appelé par le thread de capture après chaque publication
+   * (et à la fin du flux), hors verrou. À fixer avant start().
+   */
+  void setOnFrame(std::function<void()> fn) { onFrame_ = std::move(fn); }
+
+  /// Démarre le thread de capture.
+  void start();
+
+  /// Arrête le thread (attend la fin de la lecture en cours).
+  void stop();
+
+  /**
+   * @brief Attend puis récupère l'image la plus récente non encore consommée.
+   * @param[in,out] frame Reçoit la nouvelle image (échange de tampons).
+   * @param timeoutMs Délai maximal d'attente (ms).
+   * @return false si la source est terminée ou si le délai est dépassé.
+   */
+  bool waitLatest(Frame& frame, int timeoutMs = 2000);
+
+  /// true si la source a signalé la fin du flux.
+  bool finished() const;
+
+  GrabberStats stats() const;
+
+private:
+  void run();
+
+  FrameSource& src_;
+  Frame back_;              // rempli par le thread de capture
+  Frame middle_;            // dernière image publiée
+  bool fresh_ = false;      // middle_ pas encore consommée
+  bool finished_ = false;
+  GrabberStats stats_;
+  std::function<void()> onFrame_;
+
+  mutable std::mutex m_;
+  std::condition_variable cv_;
+  std::atomic<bool> stopRequested_{false};
+  std::thread thread_;
+};
+
+/**
+ * @brief Règle CAP_PROP_BUFFERSIZE (nombre de tampons du driver).
+ * @return true si le backend a accepté la valeur.
+ */
+bool setCaptureBufferSize(cv::VideoCapture& cap, int n);
+
+/// Horloge monotone en secondes (pour horodater les images).
+double monotonicSeconds();
+
+} // namespace io
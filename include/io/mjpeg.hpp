@@ -0,0 +1,98 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "io/capture.hpp"
+
+/**
+ * @file mjpeg.hpp
+ * @brief Décodage MJPEG (libjpeg-turbo si disponible) avec réduction DCT pour la détection.
+ *
+ * La webcam est ouverte en MJPG ; plutôt que de laisser OpenCV décoder chaque
+ * image en pleine résolution, on récupère le flux JPEG brut
+ * (CAP_PROP_CONVERT_RGB = false) et on produit, en un seul décodage :
+ * - l'image couleur pleine résolution (affichage),
+ * - la luminance réduite 1/2, 1/4 ou 1/8 (détection), prise sur le plan Y
+ *   déjà décodé au lieu d'un second décodage du JPEG.
+ *
+ * Sans libjpeg-turbo (AR_HAVE_TURBOJPEG non défini), on retombe sur
+ * cv::imdecode (couleur), la luminance étant convertie depuis le BGR.
+ */
+namespace io {
+
+/**
+ * @brief Décodeur JPEG réutilisable (un par thread).
+ */
+class MjpegDecoder {
+public:
+  MjpegDecoder();
+  ~MjpegDecoder();
+
+  MjpegDecoder(const MjpegDecoder&) = delete;
+  MjpegDecoder& operator=(const MjpegDecoder&) = delete;
+
+  /**
+   * @brief Décode un JPEG complet en BGR pleine résolution.
+   * @param data Données JPEG
+   * @param size Taille en octets
+   * @param[out] bgr Image BGR (tampon réutilisé si la taille ne change pas)
+   */
+  bool decodeBGR(const std::uint8_t* data, std::size_t size, cv::Mat& bgr);
+
+  /**
+   * @brief Décode une seule fois le JPEG : couleur pleine résolution et luminance réduite.
+   *
+   * Avec libjpeg-turbo, décodage vers les plans YCbCr puis conversion
+   * couleur ; la luminance est le plan Y, réduit par moyenne de blocs.
+   * @param lumaDenom Réduction de la luminance : 1, 2, 4 ou 8 (0 = pas de luminance)
+   * @param[out] bgr Image BGR pleine résolution
+   * @param[out] luma Image CV_8UC1 de taille ceil(w/lumaDenom) x ceil(h/lumaDenom), vide si lumaDenom = 0
+   */
+  bool decode(const std::uint8_t* data, std::size_t size, int lumaDenom, cv::Mat& bgr, cv::Mat& luma);
+
+  /**
+   * @brief Décode uniquement la luminance, réduite par l'IDCT.
+   * @param denom Facteur de réduction : 1, 2, 4 ou 8
+   * @param[out] gray Image CV_8UC1 de taille ceil(w/denom) x ceil(h/denom)
+   */
+  bool decodeGray(const std::uint8_t* data, std::size_t size, int denom, cv::Mat& gray);
+
+  /// true si le binaire a été compilé avec libjpeg-turbo.
+  static bool hasTurbo();
+
+private:
+  void* handle_ = nullptr;  // tjhandle (opaque pour ne pas exposer turbojpeg.h)
+  cv::Mat planes_;          // Plans Y, Cb, Cr (ou gris) de l'image en cours
+};
+
+/**
+ * @brief Source webcam MJPEG décodée hors OpenCV.
+ *
+ * Chaque image est décodée une fois (MjpegDecoder::decode) ; le décodage se fait dans read(), donc sur le thread de capture quand la
+ * source est utilisée via LatestFrameGrabber.
+ */
+class MjpegCaptureSource : public FrameSource {
+public:
+  /**
+   * @param cap Capture V4L2 déjà ouverte en MJPG, passée en mode brut (enableRawMjpeg)
+   * @param lumaDenom Réduction de la luminance pour la détection (0 = pas de luminance)
+   */
+  MjpegCaptureSource(cv::VideoCapture& cap, int lumaDenom);
+  bool read(Frame& out) override;
+
+private:
+  cv::VideoCapture& cap_;
+  MjpegDecoder decoder_;
+  cv::Mat raw_;
+  int lumaDenom_;
+  std::uint64_t seq_ = 0;
+};
+
+/**
+ * @brief Passe une capture MJPG en sortie brute (pas de décodage OpenCV).
+ * @return false si le format négocié n'est pas MJPG ou si le backend refuse.
+ */
+bool enableRawMjpeg(cv::VideoCapture& cap);
+
+} // namespace io
@@ -0,0 +1,166 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "io/capture.hpp"
+
+/**
+ * @file rawvideo.hpp
+ * @brief Conteneur vidéo brut sans perte (.arv) : écriture séquentielle alignée, relecture mmap.
+ *
+ * Sert à enregistrer les séquences de test du détecteur sans artefacts de
+ * compression, et à les rejouer sans décodage.
+ *
+ * Disposition du fichier (tout est aligné sur RAW_ALIGN = 4096 octets) :
+ * - bloc d'en-tête RawFileHeader (un bloc) ;
+ * - puis une suite d'enregistrements [RawRecordHeader | pixels | bourrage].
+ *
+ * Sans compression, tous les enregistrements ont la même taille : l'image i
+ * est à l'offset RAW_ALIGN + i * recordSize. Avec LZ4 (optionnel,
+ * AR_HAVE_LZ4), la taille varie et le lecteur construit un index à l'ouverture.
+ */
+namespace io {
+
+constexpr std::size_t RAW_ALIGN = 4096;
+
+/// En-tête de fichier (écrit dans le premier bloc).
+struct RawFileHeader {
+  char magic[8];            //!< "ARRAWV01"
+  std::uint32_t version;    //!< 1
+  std::uint32_t flags;      //!< RAW_FLAG_*
+  std::int32_t width;
+  std::int32_t height;
+  std::int32_t cvType;      //!< Type OpenCV des pixels (CV_8UC3 pour BGR)
+  std::uint32_t reserved0;
+  std::uint64_t frameBytes; //!< Taille d'une image décompressée
+  std::uint64_t frameCount; //!< Nombre d'images (mis à jour à la fermeture)
+  double fps;
+};
+
+/// En-tête de chaque enregistrement.
+struct RawRecordHeader {
+  std::uint32_t magic;       //!< RAW_RECORD_MAGIC
+  std::uint32_t flags;       //!< RAW_FLAG_LZ4 si la charge utile est compressée
+  std::uint64_t seq;
+  double timestamp;          //!< Horodatage de capture (s)
+  std::uint64_t payloadBytes;//!< Taille de la charge utile (compressée ou non)
+  std::uint64_t recordBytes; //!< Taille totale de l'enregistrement, bourrage compris
+};
+
+constexpr std::uint32_t RAW_FLAG_LZ4 = 1u;
+constexpr std::uint32_t RAW_RECORD_MAGIC = 0x304D5246u; // "FRM0"
+constexpr std::size_t RAW_PAYLOAD_OFFSET = 64;           //!< Pixels à +64 octets de l'en-tête (alignement SIMD)
+
+/**
+ * @brief Écrivain séquentiel : les enregistrements sont accumulés dans un
+ * tampon aligné et écrits par gros blocs (O_DIRECT si le système de fichiers l'accepte).
+ */
+class RawVideoWriter {
+public:
+  RawVideoWriter() = default;
+  ~RawVideoWriter();
+
+  RawVideoWriter(const RawVideoWriter&) = delete;
+  RawVideoWriter& operator=(const RawVideoWriter&) = delete;
+
+  /**
+   * @brief Crée le fichier.
+   * @param lz4 Compresse chaque image en LZ4 (ignoré si compilé sans LZ4)
+   * @param chunkBytes Taille des écritures (multiple de RAW_ALIGN)
+   */
+  bool open(const std::string& path, cv::Size size, int cvType, double fps,
+            bool lz4 = false, std::size_t chunkBytes = 8u << 20);
+
+  /// Ajoute une image (taille et type identiques à ceux d'open).
+  bool write(const cv::Mat& img, double timestamp);
+
+  /// Vide le tampon, met à jour frameCount et ferme.
+  void close();
+
+  bool isOpened() const { return fd_ >= 0; }
+  std::uint64_t frameCount() const { return header_.frameCount; }
+  std::uint64_t bytesWritten() const { return fileBytes_; }
+  bool directIO() const { return direct_; }
+
+  /// true si le binaire a été compilé avec LZ4.
+  static bool hasLz4();
+
+private:
+  bool flush();
+
+  int fd_ = -1;
+  bool direct_ = false;
+  RawFileHeader header_{};
+  std::uint8_t* chunk_ = nullptr;  // tampon aligné
+  std::size_t chunkBytes_ = 0, chunkUsed_ = 0;
+  std::uint64_t fileBytes_ = 0;
+  std::vector<char> scratch_;      // sortie LZ4
+};
+
+/**
+ * @brief Lecteur : projette le fichier en mémoire et expose les images sans copie.
+ */
+class RawVideoReader {
+public:
+  RawVideoReader() = default;
+  ~RawVideoReader();
+
+  RawVideoReader(const RawVideoReader&) = delete;
+  RawVideoReader& operator=(const RawVideoReader&) = delete;
+
+  /// @throws std::runtime_error si le fichier est invalide
+  void open(const std::string& path);
+  void close();
+
+  std::size_t frameCount() const { return offsets_.size(); }
+  cv::Size size() const { return cv::Size(header_.width, header_.height); }
+  int type() const { return header_.cvType; }
+  double fps() const { return header_.fps; }
+
+  /**
+   * @brief Image i.
+   *
+   * Non compressée : vue en lecture seule directement sur la projection mmap
+   * (ne pas écrire dedans). Compressée : décompressée dans un tampon interne,
+   * valide jusqu'au prochain appel.
+   */
+  cv::Mat frame(std::size_t i);
+
+  /**
+   * @brief Décompresse (ou copie) l'image i dans dst, qui reste réutilisable d'un appel à l'autre.
+   */
+  void decode(std::size_t i, cv::Mat& dst);
+
+  /// En-tête de l'enregistrement i (seq, timestamp).
+  const RawRecordHeader& record(std::size_t i) const;
+
+  /// Garde la projection en vie (à stocker dans Frame::owner).
+  std::shared_ptr<void> mapping() const { return map_; }
+
+private:
+  std::shared_ptr<void> map_;      // munmap à la destruction du dernier détenteur
+  std::size_t mapBytes_ = 0;
+  RawFileHeader header_{};
+  std::vector<std::size_t> offsets_;
+  cv::Mat decoded_;
+};
+
+/**
+ * @brief Source de rejeu pour l'application AR (images BGR, sans décodage).
+ */
+class RawVideoSource : public FrameSource {
+public:
+  explicit RawVideoSource(const std::string& path);
+  bool read(Frame& out) override;
+
+  RawVideoReader& reader() { return reader_; }
+
+private:
+  RawVideoReader reader_;
+  std::size_t next_ = 0;
+};
+
+} // namespace io
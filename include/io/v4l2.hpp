@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "io/capture.hpp"
+
+/**
+ * @file v4l2.hpp
+ * @brief Backend de capture V4L2 natif (tampons mmap, sans copie).
+ *
+ * Les tampons du driver (VIDIOC_REQBUFS + mmap) sont exposés directement comme
+ * en-têtes cv::Mat dans Frame::yuv : pas de copie ni de conversion YUYV -> BGR
+ * côté capture. Pour NV12, Frame::luma est une vue sur le plan Y ; pour YUYV,
+ * la luminance est extraite en une passe (octets pairs).
+ *
+ * Un tampon est rendu au driver (VIDIOC_QBUF) quand le dernier Frame qui le
+ * référence (Frame::owner) est réécrit ou détruit. Les horodatages sont ceux
+ * du noyau (CLOCK_MONOTONIC), comparables à io::monotonicSeconds().
+ *
+ * Testable sans caméra avec le driver virtuel : `sudo modprobe vivid`.
+ */
+namespace io {
+
+/**
+ * @brief Paramètres demandés au driver.
+ */
+struct V4l2Config {
+  std::string device = "/dev/video0";
+  int width  = 1280;
+  int height = 720;
+  int fps    = 30;
+  int bufferCount = 6;      //!< Tampons mmap (>= 3 pour le triple tampon + 1 chez le driver)
+  bool preferNV12 = false;  //!< Essaye NV12 avant YUYV
+};
+
+/**
+ * @brief Source V4L2 mmap (Linux uniquement).
+ */
+class V4l2Source : public FrameSource {
+public:
+  V4l2Source();
+  ~V4l2Source() override;
+
+  /**
+   * @brief Ouvre le périphérique, négocie le format et démarre le streaming.
+   * @throws std::runtime_error si le périphérique ou le format est inutilisable
+   */
+  void open(const V4l2Config& cfg);
+
+  bool read(Frame& out) override;
+
+  int width() const;
+  int height() const;
+  double fps() const;
+  PixelFormat format() const;
+
+private:
+  struct Impl;
+  std::shared_ptr<Impl> impl_;  // partagé avec les Frame::owner encore en vie
+  std::uint64_t seq_ = 0;
+};
+
+} // namespace io
@@ -1,5 +1,7 @@
 #include "ar/calib.hpp"
 #include <opencv2/core.hpp>
+#include <cmath>
+#include <iostream>
 #include <stdexcept>
 
 namespace ar {
@@ -29,6 +31,42 @@ Calibration loadCalibration(const std::string& filename) {
   c.cameraMatrix.convertTo(c.cameraMatrix, CV_64F);
   c.distCoeffs.convertTo(c.distCoeffs, CV_64F);
 
+  // Résolution native : sans elle, K ne peut pas être mise à l'échelle
+  int w = 0, h = 0;
+  if (!fs["image_width"].empty())  fs["image_width"] >> w;
+  if (!fs["image_height"].empty()) fs["image_height"] >> h;
+  if (w > 0 && h > 0)
+    c.imageSize = cv::Size(w, h);
+  else
+    std::cerr << "[WARN] " << filename << " : image_width / image_height absents, "
+              << "K utilisée telle quelle quelle que soit la résolution\n";
+
+  return c;
+}
+
+/**
+ * @brief Recalcule K pour une autre résolution (même champ de vue).
+ *
+ * @param calib calibration source (imageSize renseignée).
+ * @param size résolution cible.
+ * @return Calibration valide pour size.
+ */
+Calibration scaleCalibration(const Calibration& calib, cv::Size size) {
+  Calibration c{};
+  c.cameraMatrix = calib.cameraMatrix.clone();
+  c.distCoeffs = calib.distCoeffs.clone();
+  c.imageSize = size;
+  if (calib.imageSize.width <= 0 || calib.imageSize.height <= 0 || size == calib.imageSize)
+    return c;
+
+  const double sx = (double)size.width / calib.imageSize.width;
+  const double sy = (double)size.height / calib.imageSize.height;
+  cv::Mat& K = c.cameraMatrix;
+  K.at<double>(0,0) *= sx;
+  K.at<double>(0,1) *= sx;                                   // skew
+  K.at<double>(1,1) *= sy;
+  K.at<double>(0,2) = (K.at<double>(0,2) + 0.5) * sx - 0.5;  // centres de pixels
+  K.at<double>(1,2) = (K.at<double>(1,2) + 0.5) * sy - 0.5;
   return c;
 }
 
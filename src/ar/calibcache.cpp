@@ -0,0 +1,195 @@
+#include "ar/calibcache.hpp"
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgproc.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ar {
+
+static_assert(sizeof(CalibCacheHeader) == 128, "en-tête de cache : 128 octets attendus");
+
+static constexpr std::size_t BLOCK = 64;
+static std::size_t alignUp(std::size_t n) { return (n + BLOCK - 1) / BLOCK * BLOCK; }
+
+// FNV-1a 64 bits
+static std::uint64_t fnv1a(const void* data, std::size_t n) {
+  const auto* p = static_cast<const std::uint8_t*>(data);
+  std::uint64_t h = 1469598103934665603ull;
+  for (std::size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+  return h;
+}
+
+// Somme de contrôle de la charge utile (LUT de plusieurs Mo) : FNV par mots de 64 bits
+static std::uint64_t checksum(const std::uint8_t* data, std::size_t n) {
+  std::uint64_t h = 1469598103934665603ull;
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    std::uint64_t w; std::memcpy(&w, data + i, 8);
+    h = (h ^ w) * 1099511628211ull;
+  }
+  return h ^ fnv1a(data + i, n - i);
+}
+
+// Blocs de la charge utile (offsets relatifs à la fin de l'en-tête)
+struct Layout {
+  std::size_t k, dist, ndc, map1, map2, total;
+};
+
+static Layout layoutFor(std::uint32_t distCount, cv::Size size, bool lut) {
+  Layout l{};
+  l.k    = 0;
+  l.dist = alignUp(l.k + 9 * sizeof(double));
+  l.ndc  = alignUp(l.dist + distCount * sizeof(double));
+  l.map1 = alignUp(l.ndc + 4 * sizeof(double));
+  const std::size_t px = lut ? (std::size_t)size.area() : 0;
+  l.map2 = alignUp(l.map1 + px * 2 * sizeof(std::int16_t));
+  l.total = alignUp(l.map2 + px * sizeof(std::uint16_t));
+  return l;
+}
+
+static cv::Vec4d ndcFromK(const cv::Mat& K, cv::Size size) {
+  const double w = size.width, h = size.height;
+  return cv::Vec4d(2.0 * K.at<double>(0,0) / w, 2.0 * K.at<double>(1,1) / h,
+                   1.0 - 2.0 * K.at<double>(0,2) / w, 2.0 * K.at<double>(1,2) / h - 1.0);
+}
+
+static std::string cachePathFor(const std::string& yamlPath, cv::Size size) {
+  return yamlPath + "." + std::to_string(size.width) + "x" + std::to_string(size.height) + ".arcal";
+}
+
+/**
+ * @brief Projette le cache et le valide ; false s'il est absent, périmé ou corrompu.
+ */
+static bool tryLoad(const std::string& path, const CalibCacheHeader& key, bool withUndistort,
+                    PreparedCalibration& out) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st{};
+  if (fstat(fd, &st) != 0 || (std::size_t)st.st_size < sizeof(CalibCacheHeader)) { ::close(fd); return false; }
+  const std::size_t bytes = (std::size_t)st.st_size;
+  void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) return false;
+  std::shared_ptr<void> map(p, [bytes](void* q) { munmap(q, bytes); });
+
+  const auto* base = static_cast<const std::uint8_t*>(p);
+  CalibCacheHeader h;
+  std::memcpy(&h, base, sizeof(h));
+  if (std::memcmp(h.magic, key.magic, 8) != 0 || h.version != key.version ||
+      h.yamlMtime != key.yamlMtime || h.yamlSize != key.yamlSize || h.yamlHash != key.yamlHash ||
+      h.width != key.width || h.height != key.height)
+    return false;
+  const bool hasLut = (h.flags & CALIB_CACHE_HAS_LUT) != 0;
+  if (withUndistort && !hasLut) return false;
+
+  const cv::Size size(h.width, h.height);
+  const Layout l = layoutFor(h.distCount, size, hasLut);
+  if (sizeof(h) + l.total != bytes) return false;
+  const std::uint8_t* payload = base + sizeof(h);
+  if (checksum(payload, l.total) != h.checksum) return false;
+
+  auto* d = reinterpret_cast<double*>(const_cast<std::uint8_t*>(payload));
+  out.calib.cameraMatrix = cv::Mat(3, 3, CV_64F, d + l.k / sizeof(double)).clone();
+  out.calib.distCoeffs = cv::Mat(1, (int)h.distCount, CV_64F, d + l.dist / sizeof(double)).clone();
+  const double* ndc = d + l.ndc / sizeof(double);
+  out.ndc = cv::Vec4d(ndc[0], ndc[1], ndc[2], ndc[3]);
+  out.calib.imageSize = size;
+  out.imageSize = size;
+  out.nativeSize = cv::Size(h.nativeWidth, h.nativeHeight);
+  if (withUndistort) {
+    // Vues en lecture seule sur la projection (pas de copie)
+    auto* mp = const_cast<std::uint8_t*>(payload);
+    out.undistMap1 = cv::Mat(size, CV_16SC2, mp + l.map1);
+    out.undistMap2 = cv::Mat(size, CV_16UC1, mp + l.map2);
+    out.mapping = std::move(map);
+  }
+  out.fromCache = true;
+  return true;
+}
+
+/**
+ * @brief Écrit le cache dans un fichier temporaire renommé ensuite
+ * (plusieurs processus peuvent démarrer en même temps sur le même YAML).
+ */
+static void writeCache(const std::string& path, CalibCacheHeader h, const PreparedCalibration& pc) {
+  const bool lut = !pc.undistMap1.empty();
+  h.flags = lut ? CALIB_CACHE_HAS_LUT : 0u;
+  h.distCount = (std::uint32_t)pc.calib.distCoeffs.total();
+  h.nativeWidth = pc.nativeSize.width;
+  h.nativeHeight = pc.nativeSize.height;
+  const Layout l = layoutFor(h.distCount, pc.imageSize, lut);
+
+  std::vector<std::uint8_t> buf(sizeof(h) + l.total, 0);
+  std::uint8_t* payload = buf.data() + sizeof(h);
+  cv::Mat K = pc.calib.cameraMatrix.reshape(1, 1), dist = pc.calib.distCoeffs.reshape(1, 1);
+  std::memcpy(payload + l.k, K.clone().ptr<double>(), 9 * sizeof(double));
+  std::memcpy(payload + l.dist, dist.clone().ptr<double>(), h.distCount * sizeof(double));
+  std::memcpy(payload + l.ndc, pc.ndc.val, 4 * sizeof(double));
+  if (lut) {
+    const cv::Mat m1 = pc.undistMap1.isContinuous() ? pc.undistMap1 : pc.undistMap1.clone();
+    const cv::Mat m2 = pc.undistMap2.isContinuous() ? pc.undistMap2 : pc.undistMap2.clone();
+    std::memcpy(payload + l.map1, m1.data, m1.total() * m1.elemSize());
+    std::memcpy(payload + l.map2, m2.data, m2.total() * m2.elemSize());
+  }
+  h.checksum = checksum(payload, l.total);
+  std::memcpy(buf.data(), &h, sizeof(h));
+
+  const std::string tmp = path + ".tmp" + std::to_string((long)getpid());
+  std::ofstream f(tmp, std::ios::binary);
+  if (!f || !f.write(reinterpret_cast<const char*>(buf.data()), (std::streamsize)buf.size())) {
+    std::remove(tmp.c_str());
+    std::cerr << "[WARN] Cache de calibration non écrit : " << path << "\n";
+    return;
+  }
+  f.close();
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) std::remove(tmp.c_str());
+}
+
+PreparedCalibration loadCalibrationCached(const std::string& yamlPath, cv::Size imageSize,
+                                          bool withUndistort) {
+  // Clé : identité du YAML (date, taille, contenu) + résolution
+  struct stat st{};
+  if (stat(yamlPath.c_str(), &st) != 0)
+    throw std::runtime_error("Impossible d'ouvrir " + yamlPath);
+  std::ifstream in(yamlPath, std::ios::binary);
+  const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  CalibCacheHeader key{};
+  std::memcpy(key.magic, "ARCALIB1", 8);
+  key.version = CALIB_CACHE_VERSION;
+  key.yamlMtime = (std::int64_t)st.st_mtim.tv_sec * 1000000000ll + st.st_mtim.tv_nsec;
+  key.yamlSize = (std::uint64_t)st.st_size;
+  key.yamlHash = fnv1a(text.data(), text.size());
+  key.width = imageSize.width;
+  key.height = imageSize.height;
+
+  const std::string cachePath = cachePathFor(yamlPath, imageSize);
+  PreparedCalibration pc;
+  if (tryLoad(cachePath, key, withUndistort, pc)) return pc;
+
+  // Cache absent ou périmé : chemin lent, puis écriture du cache
+  pc = PreparedCalibration{};
+  const Calibration native = loadCalibration(yamlPath);
+  pc.calib = scaleCalibration(native, imageSize);
+  pc.nativeSize = native.imageSize;
+  pc.imageSize = imageSize;
+  pc.ndc = ndcFromK(pc.calib.cameraMatrix, imageSize);
+  if (withUndistort)
+    cv::initUndistortRectifyMap(pc.calib.cameraMatrix, pc.calib.distCoeffs, cv::Mat(),
+                                pc.calib.cameraMatrix, imageSize, CV_16SC2,
+                                pc.undistMap1, pc.undistMap2);
+  writeCache(cachePath, key, pc);
+  return pc;
+}
+
+} // namespace ar
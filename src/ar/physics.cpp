@@ -4,6 +4,23 @@
 
 namespace ar {
 
+std::vector<std::array<float, 4>> a4FrameWalls() {
+    // Les murs Verticaux sont "LONGS" : ils vont jusqu'à 148.5 + 5mm = 153.5
+    const float longY = 148.5f + 5.0f;
+    // Les murs Horizontaux sont "COURTS" : ils s'arrêtent à 105 - 5mm = 100
+    const float shortX = 105.0f - 5.0f;
+
+    return {
+        // --- Murs Verticaux (Gauche & Droite) ---
+        {-105.f, -longY, -105.f, +longY}, // Gauche
+        {+105.f, -longY, +105.f, +longY}, // Droite
+
+        // --- Murs Horizontaux (Haut & Bas) ---
+        {-shortX, +148.5f, +shortX, +148.5f}, // Haut
+        {-shortX, -148.5f, +shortX, -148.5f}  // Bas
+    };
+}
+
 // --- La fonction de base (Maths pures) ---
 void resolveWallCollision(glm::vec3& pos, glm::vec3& vel, float radius, 
                           float x1, float y1, float x2, float y2) {
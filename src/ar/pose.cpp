@@ -20,11 +20,24 @@ glm::mat4 projectionFromCV(const cv::Mat& K, float w, float h, float n, float f)
   const double cx = K.at<double>(0,2);
   const double cy = K.at<double>(1,2);
 
+  return projectionFromNDC(cv::Vec4d(2.0 * fx / w, 2.0 * fy / h,
+                                     1.0 - 2.0 * cx / w, 2.0 * cy / h - 1.0), n, f);
+}
+
+/**
+ * @brief Construit la matrice de projection OpenGL depuis les coefficients normalisés.
+ *
+ * @param ndc (2fx/w, 2fy/h, 1-2cx/w, 2cy/h-1).
+ * @param n plan proche.
+ * @param f plan lointain.
+ * @return glm::mat4 matrice de projection.
+ */
+glm::mat4 projectionFromNDC(const cv::Vec4d& ndc, float n, float f) {
   glm::mat4 P(0.0f);
-  P[0][0] =  2.0f * static_cast<float>(fx) / w;
-  P[1][1] =  2.0f * static_cast<float>(fy) / h;
-  P[2][0] =  1.0f - 2.0f * static_cast<float>(cx) / w;
-  P[2][1] =  2.0f * static_cast<float>(cy) / h - 1.0f;
+  P[0][0] = static_cast<float>(ndc[0]);
+  P[1][1] = static_cast<float>(ndc[1]);
+  P[2][0] = static_cast<float>(ndc[2]);
+  P[2][1] = static_cast<float>(ndc[3]);
   P[2][2] = -(f + n) / (f - n);
   P[2][3] = -1.0f;
   P[3][2] = -2.0f * f * n / (f - n);
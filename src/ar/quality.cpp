@@ -0,0 +1,104 @@
+#include "ar/quality.hpp"
+#include <algorithm>
+#include <ostream>
+
+namespace ar {
+
+namespace {
+
+// Échelles de niveaux par étape (indice 0 = meilleure qualité)
+struct VisionLevel { int denom, interval; };
+constexpr VisionLevel VISION_LEVELS[] = {{1,1}, {2,1}, {2,2}, {4,2}, {4,3}, {4,4}};
+constexpr int PHYSICS_SUBSTEPS[] = {4, 2, 1};
+constexpr float RENDER_SCALE_MAX[] = {1.0f, 0.85f, 0.7f, 0.5f};
+
+constexpr int LEVEL_COUNT[] = {
+  (int)(sizeof(VISION_LEVELS) / sizeof(VISION_LEVELS[0])),
+  (int)(sizeof(PHYSICS_SUBSTEPS) / sizeof(PHYSICS_SUBSTEPS[0])),
+  (int)(sizeof(RENDER_SCALE_MAX) / sizeof(RENDER_SCALE_MAX[0])),
+};
+
+constexpr const char* STAGE_NAMES[] = {"vision", "physique", "rendu"};
+
+constexpr double EMA = 0.1;           // Poids d'une nouvelle mesure
+constexpr int WARMUP_FRAMES = 30;     // Démarrage (chargements, caches) ignoré
+constexpr int OVER_FRAMES = 15;       // Dépassement soutenu avant de dégrader
+constexpr int CALM_FRAMES = 90;       // Marge soutenue avant de restaurer
+constexpr int COOLDOWN_FRAMES = 30;   // Pause après chaque décision
+constexpr double CALM_RATIO = 0.6;    // "Largement sous le budget"
+
+} // namespace
+
+QualityController::QualityController(double targetFps, std::ostream* log)
+  : budgetMs_(targetFps > 0.0 ? 1000.0 / targetFps : 0.0), log_(log) {
+  apply();
+}
+
+void QualityController::record(Stage stage, double ms) { cur_[(int)stage] += ms; }
+
+double QualityController::averageFrameMs() const {
+  double t = 0.0;
+  for (double a : avg_) t += a;
+  return t;
+}
+
+bool QualityController::endFrame() {
+  for (int s = 0; s < (int)Stage::Count; ++s) {
+    avg_[s] = frames_ == 0 ? cur_[s] : (1.0 - EMA) * avg_[s] + EMA * cur_[s];
+    cur_[s] = 0.0;
+  }
+  if (++frames_ < WARMUP_FRAMES || budgetMs_ <= 0.0) return false;
+  if (cooldown_ > 0) { --cooldown_; return false; }
+
+  const double frame = averageFrameMs();
+  overFrames_ = frame > budgetMs_ ? overFrames_ + 1 : 0;
+  calmFrames_ = frame < CALM_RATIO * budgetMs_ ? calmFrames_ + 1 : 0;
+
+  if (overFrames_ >= OVER_FRAMES) {
+    // Étapes dégradables, de la plus chère à la moins chère
+    std::array<int, (int)Stage::Count> order{0, 1, 2};
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return avg_[a] > avg_[b]; });
+    for (int s : order) {
+      if (level_[s] + 1 >= LEVEL_COUNT[s]) continue;
+      ++level_[s];
+      degraded_.push_back((Stage)s);
+      apply();
+      logDecision("dégradation", (Stage)s);
+      overFrames_ = 0;
+      cooldown_ = COOLDOWN_FRAMES;
+      return true;
+    }
+    overFrames_ = 0;   // Tout est au minimum
+  } else if (calmFrames_ >= CALM_FRAMES && !degraded_.empty()) {
+    const Stage s = degraded_.back();
+    degraded_.pop_back();
+    --level_[(int)s];
+    apply();
+    logDecision("restauration", s);
+    calmFrames_ = 0;
+    cooldown_ = COOLDOWN_FRAMES;
+    return true;
+  }
+  return false;
+}
+
+void QualityController::apply() {
+  const VisionLevel& v = VISION_LEVELS[level_[(int)Stage::Vision]];
+  settings_.detectDenom = v.denom;
+  settings_.detectInterval = v.interval;
+  settings_.physicsSubsteps = PHYSICS_SUBSTEPS[level_[(int)Stage::Physics]];
+  settings_.renderScaleMax = RENDER_SCALE_MAX[level_[(int)Stage::Render]];
+}
+
+void QualityController::logDecision(const char* what, Stage stage) {
+  if (!log_) return;
+  *log_ << "[QUALITE] " << what << " " << STAGE_NAMES[(int)stage]
+        << " -> niveau " << level_[(int)stage]
+        << " (image " << averageFrameMs() << " ms, budget " << budgetMs_ << " ms ; vision "
+        << avg_[(int)Stage::Vision] << ", physique " << avg_[(int)Stage::Physics]
+        << ", rendu " << avg_[(int)Stage::Render] << ") : détection 1/" << settings_.detectDenom
+        << " une image sur " << settings_.detectInterval << ", " << settings_.physicsSubsteps
+        << " sous-pas, échelle 3D <= " << settings_.renderScaleMax << "\n";
+}
+
+} // namespace ar
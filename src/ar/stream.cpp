@@ -0,0 +1,153 @@
+#include "ar/stream.hpp"
+#include "ar/physics.hpp"
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace ar {
+
+// Coins 3D de la feuille A4 (mm), même ordre que detect::A4Tracker
+static const std::vector<cv::Point3f>& a4ObjectPoints() {
+  static const std::vector<cv::Point3f> pts = {
+    {-105.f, -148.5f, 0.f}, {+105.f, -148.5f, 0.f}, {+105.f, +148.5f, 0.f}, {-105.f, +148.5f, 0.f}
+  };
+  return pts;
+}
+
+static constexpr float BALL_RADIUS = 8.f;
+static constexpr int PHYSICS_SUBSTEPS = 4;
+
+StreamProcessor::StreamProcessor(std::string name, std::unique_ptr<io::FrameSource> source,
+                                 std::string calibPath)
+    : name_(std::move(name)), source_(std::move(source)), calibPath_(std::move(calibPath)),
+      walls_(a4FrameWalls()) {}
+
+StreamProcessor::~StreamProcessor() { stop(); }
+
+void StreamProcessor::start(WorkStealingPool& pool) {
+  pool_ = &pool;
+  if (!source_->read(frame_))
+    throw std::runtime_error(name_ + " : première image vide");
+  prepared_ = loadCalibrationCached(calibPath_, frame_.size());
+  lastTimestamp_ = frame_.timestamp;
+  windowStart_ = io::monotonicSeconds();
+
+  grabber_ = std::make_unique<io::LatestFrameGrabber>(*source_);
+  grabber_->setOnFrame([this] { onFrame(); });
+  grabber_->start();
+}
+
+void StreamProcessor::stop() {
+  if (!grabber_) return;
+  grabber_->stop();   // plus de rappel après ceci
+  stopping_ = true;
+  std::unique_lock<std::mutex> lk(idleM_);
+  idleCv_.wait(lk, [this] { return !busy_; });
+}
+
+bool StreamProcessor::finished() const {
+  return grabber_ && grabber_->finished() && !busy_;
+}
+
+// Nouvelle image publiée : un cycle est lancé si le flux est libre, sinon le
+// cycle en cours en relancera un à sa fin (pending_)
+void StreamProcessor::onFrame() {
+  pending_ = true;
+  if (!busy_.exchange(true)) pool_->submit([this] { visionTask(); });
+}
+
+// Sous idleM_ : une fois stop() réveillé, plus rien ne touche au flux
+void StreamProcessor::endCycle() {
+  std::lock_guard<std::mutex> lk(idleM_);
+  busy_ = false;
+  if (pending_ && !stopping_ && !busy_.exchange(true)) {
+    pool_->submit([this] { visionTask(); });
+    return;
+  }
+  idleCv_.notify_all();
+}
+
+void StreamProcessor::visionTask() {
+  pending_ = false;
+  if (!grabber_->waitLatest(frame_, 0)) { endCycle(); return; }
+  try {
+    const double t0 = io::monotonicSeconds();
+
+    // Luminance de détection : celle de la source (V4L2, MJPEG réduit) sinon conversion
+    const cv::Mat* luma = &frame_.luma;
+    int denom = frame_.lumaDenom;
+    if (frame_.luma.empty()) {
+      cv::cvtColor(io::ensureBGR(frame_), gray_, cv::COLOR_BGR2GRAY);
+      luma = &gray_;
+      denom = 1;
+    }
+
+    bool gated = gate_.isStatic(*luma, denom, found_ ? corners_ : std::vector<cv::Point2f>());
+    if (!gated) {
+      std::vector<cv::Point2f> pts;
+      found_ = tracker_.detectLuma(*luma, pts, denom);
+      if (found_) {
+        corners_ = pts;
+        cv::solvePnP(a4ObjectPoints(), corners_, prepared_.calib.cameraMatrix, prepared_.calib.distCoeffs,
+                     rvec_, tvec_, !rvec_.empty(), cv::SOLVEPNP_ITERATIVE);
+      }
+    }
+    visionMs_ = 1000.0 * (io::monotonicSeconds() - t0);
+    {
+      std::lock_guard<std::mutex> lk(statsM_);
+      if (gated) ++stats_.gated;
+    }
+
+    // Suite dans la file de ce worker (données de l'image encore en cache)
+    pool_->submit([this] { physicsTask(); });
+  } catch (const std::exception& e) {
+    // Image perdue pour ce flux seulement ; le cycle doit se terminer (cf. stop())
+    std::cerr << "[ERREUR] " << name_ << " : " << e.what() << "\n";
+    endCycle();
+  }
+}
+
+void StreamProcessor::physicsTask() {
+  try {
+    const double t0 = io::monotonicSeconds();
+    float dt = (float)(frame_.timestamp - lastTimestamp_);
+    lastTimestamp_ = frame_.timestamp;
+    dt = std::min(std::max(dt, 0.f), 0.05f);
+
+    if (found_ && !rvec_.empty())
+      for (int k = 0; k < PHYSICS_SUBSTEPS; ++k)
+        updatePhysics(rvec_, dt / PHYSICS_SUBSTEPS, ballPos_, ballVel_, ballRotation_,
+                      BALL_RADIUS, walls_, A4_WALL_THICKNESS);
+
+    const double t1 = io::monotonicSeconds();
+    std::lock_guard<std::mutex> lk(statsM_);
+    const double latencyMs = 1000.0 * (t1 - frame_.timestamp);
+    ++stats_.frames;
+    if (found_) ++stats_.detected;
+    stats_.latencySumMs += latencyMs;
+    stats_.latencyMaxMs = std::max(stats_.latencyMaxMs, latencyMs);
+    stats_.visionSumMs += visionMs_;
+    stats_.physicsSumMs += 1000.0 * (t1 - t0);
+  } catch (const std::exception& e) {
+    // Comme visionTask : image perdue pour ce flux, le cycle se termine quand même
+    std::cerr << "[ERREUR] " << name_ << " : " << e.what() << "\n";
+  }
+  endCycle();
+}
+
+StreamStats StreamProcessor::takeStats() {
+  const double now = io::monotonicSeconds();
+  const std::uint64_t dropped = grabber_ ? grabber_->stats().dropped : 0;
+  std::lock_guard<std::mutex> lk(statsM_);
+  StreamStats s = stats_;
+  s.seconds = now - windowStart_;
+  s.dropped = dropped - droppedBase_;
+  stats_ = StreamStats{};
+  windowStart_ = now;
+  droppedBase_ = dropped;
+  return s;
+}
+
+} // namespace ar
@@ -0,0 +1,97 @@
+#include "ar/workpool.hpp"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace ar {
+
+// Worker courant (pour qu'une tâche soumette sa suite dans sa propre file)
+static thread_local const WorkStealingPool* tlsPool = nullptr;
+static thread_local unsigned tlsIndex = 0;
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+  for (unsigned i = 0; i < threads; ++i) threads_.emplace_back(&WorkStealingPool::run, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lk(sleepM_);
+    stop_ = true;
+  }
+  sleepCv_.notify_all();
+  for (auto& t : threads_) t.join();
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+  const unsigned q = tlsPool == this ? tlsIndex
+                                     : nextQueue_.fetch_add(1, std::memory_order_relaxed) % size();
+  {
+    // Compté avant l'ajout (jamais négatif), sous le verrou du sommeil :
+    // pas de réveil perdu entre le test d'un worker et son attente
+    std::lock_guard<std::mutex> lk(sleepM_);
+    ++pending_;
+  }
+  {
+    std::lock_guard<std::mutex> lk(queues_[q]->m);
+    queues_[q]->tasks.push_back(std::move(task));
+  }
+  sleepCv_.notify_one();
+}
+
+bool WorkStealingPool::popLocal(unsigned self, std::function<void()>& task) {
+  Queue& q = *queues_[self];
+  std::lock_guard<std::mutex> lk(q.m);
+  if (q.tasks.empty()) return false;
+  task = std::move(q.tasks.back());
+  q.tasks.pop_back();
+  return true;
+}
+
+bool WorkStealingPool::steal(unsigned self, std::function<void()>& task) {
+  const unsigned n = size();
+  for (unsigned k = 1; k < n; ++k) {
+    Queue& q = *queues_[(self + k) % n];
+    std::lock_guard<std::mutex> lk(q.m);
+    if (q.tasks.empty()) continue;
+    task = std::move(q.tasks.front());
+    q.tasks.pop_front();
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingPool::run(unsigned self) {
+  tlsPool = this;
+  tlsIndex = self;
+  std::function<void()> task;
+  while (true) {
+    bool stolen = false;
+    if (!popLocal(self, task)) stolen = steal(self, task);
+    if (!task) {
+      std::unique_lock<std::mutex> lk(sleepM_);
+      sleepCv_.wait(lk, [this] { return stop_ || pending_ > 0; });
+      if (stop_) return;
+      continue;   // une tâche est en file quelque part : on la cherche
+    }
+    --pending_;
+    if (stolen) ++stolen_;
+    try {
+      task();
+    } catch (const std::exception& e) {
+      std::cerr << "[ERREUR] Tâche du pool : " << e.what() << "\n";
+    }
+    task = nullptr;
+    ++executed_;
+  }
+}
+
+WorkPoolStats WorkStealingPool::stats() const {
+  WorkPoolStats s;
+  s.executed = executed_;
+  s.stolen = stolen_;
+  return s;
+}
+
+} // namespace ar
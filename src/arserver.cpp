@@ -0,0 +1,190 @@
+// Serveur AR multi-caméras : N sources traitées sans fenêtre sur un pool de threads partagé.
+// Chaque source a son détecteur A4, sa pose et son monde physique (ar::StreamProcessor) ;
+// vision et physique de toutes les sources passent par un seul pool à vol de tâches.
+//
+// Usage : ./AR_A4_Server [--threads N] [--duration S] [--stats S] [--fps F]
+//                        [--calib fichier.yaml] source [[--calib autre.yaml] source ...]
+// source : /dev/videoN (V4L2 natif), http://, https://, rtsp:// (flux réseau),
+//          *.arv (enregistrement brut), sinon fichier vidéo.
+// --calib s'applique aux sources qui le suivent. Les fichiers sont lus à leur
+// cadence (--fps si inconnue) pour se comporter comme des caméras.
+
+#include <opencv2/videoio.hpp>
+#include "ar/stream.hpp"          // Un flux : capture, vision, pose, physique
+#include "ar/workpool.hpp"        // Pool de threads à vol de tâches
+#include "io/capture.hpp"
+#include "io/rawvideo.hpp"        // Rejeu des enregistrements bruts .arv
+#include "io/v4l2.hpp"            // Backend V4L2 natif
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> interrupted{false};
+
+void onSignal(int) { interrupted = true; }
+
+bool startsWith(const std::string& s, const std::string& prefix) {
+  return s.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/// cv::VideoCapture possédé par la source (fichier ou URL).
+class OwnedCaptureSource : public io::FrameSource {
+public:
+  explicit OwnedCaptureSource(const std::string& path) : src_(cap_) {
+    if (!cap_.open(path)) throw std::runtime_error("Impossible d'ouvrir " + path);
+  }
+  bool read(io::Frame& out) override { return src_.read(out); }
+  double fps() const { return cap_.get(cv::CAP_PROP_FPS); }
+
+private:
+  cv::VideoCapture cap_;
+  io::VideoCaptureSource src_;
+};
+
+/// Lecture cadencée : un fichier se comporte comme une caméra à fps images/s.
+class PacedSource : public io::FrameSource {
+public:
+  PacedSource(std::unique_ptr<io::FrameSource> inner, double fps)
+      : inner_(std::move(inner)), period_(std::chrono::duration<double>(1.0 / fps)) {}
+
+  bool read(io::Frame& out) override {
+    const auto now = std::chrono::steady_clock::now();
+    if (next_ < now) next_ = now;   // en retard : pas de rattrapage en rafale
+    std::this_thread::sleep_until(next_);
+    next_ += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period_);
+    return inner_->read(out);
+  }
+
+private:
+  std::unique_ptr<io::FrameSource> inner_;
+  std::chrono::duration<double> period_;
+  std::chrono::steady_clock::time_point next_{};
+};
+
+std::unique_ptr<io::FrameSource> openSource(const std::string& spec, double defaultFps) {
+  if (startsWith(spec, "/dev/video")) {
+    auto v4l2 = std::make_unique<io::V4l2Source>();
+    io::V4l2Config cfg;
+    cfg.device = spec;
+    v4l2->open(cfg);
+    return v4l2;
+  }
+  if (startsWith(spec, "http://") || startsWith(spec, "https://") || startsWith(spec, "rtsp://"))
+    return std::make_unique<OwnedCaptureSource>(spec);
+
+  if (endsWith(spec, ".arv")) {
+    auto raw = std::make_unique<io::RawVideoSource>(spec);
+    const double fps = raw->reader().fps() > 0 ? raw->reader().fps() : defaultFps;
+    return std::make_unique<PacedSource>(std::move(raw), fps);
+  }
+  auto file = std::make_unique<OwnedCaptureSource>(spec);
+  const double fps = file->fps() > 0 ? file->fps() : defaultFps;
+  return std::make_unique<PacedSource>(std::move(file), fps);
+}
+
+void printStats(const ar::StreamProcessor& s, const ar::StreamStats& st) {
+  const double n = st.frames > 0 ? (double)st.frames : 1.0;
+  char line[256];
+  std::snprintf(line, sizeof(line),
+                "[%s] %5.1f img/s | latence %5.1f ms (max %5.1f) | vision %5.2f ms | physique %5.3f ms"
+                " | A4 %3.0f%% | fixe %3.0f%% | perdues %llu",
+                s.name().c_str(), st.fps(), st.latencySumMs / n, st.latencyMaxMs,
+                st.visionSumMs / n, st.physicsSumMs / n,
+                100.0 * st.detected / n, 100.0 * st.gated / n, (unsigned long long)st.dropped);
+  std::cout << line << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  try {
+    unsigned threads = 0;            // --threads N : workers du pool (0 = un par cœur)
+    double duration = 0;             // --duration S : arrêt après S secondes (0 = fin des sources)
+    double statsInterval = 5;        // --stats S : période d'affichage des statistiques
+    double defaultFps = 30;          // --fps F : cadence des fichiers sans fps connu
+    std::string calibPath = "../data/camera.yaml";
+    std::vector<std::pair<std::string, std::string>> specs;   // (source, calibration)
+
+    for (int i = 1; i < argc; ++i) {
+      const std::string a = argv[i];
+      const bool hasValue = i + 1 < argc;
+      if      (a == "--threads"  && hasValue) threads = (unsigned)std::stoi(argv[++i]);
+      else if (a == "--duration" && hasValue) duration = std::stod(argv[++i]);
+      else if (a == "--stats"    && hasValue) statsInterval = std::stod(argv[++i]);
+      else if (a == "--fps"      && hasValue) defaultFps = std::stod(argv[++i]);
+      else if (a == "--calib"    && hasValue) calibPath = argv[++i];
+      else if (startsWith(a, "--")) {
+        std::cerr << "Argument inconnu : " << a << "\n";
+        return -1;
+      }
+      else specs.emplace_back(a, calibPath);
+    }
+    if (specs.empty()) {
+      std::cerr << "Usage: ./AR_A4_Server [--threads N] [--duration S] [--stats S] [--fps F]\n"
+                << "                      [--calib fichier.yaml] source [source ...]\n"
+                << "source : /dev/videoN, http(s)://..., rtsp://..., fichier.arv ou fichier vidéo\n";
+      return -1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // Le pool est déclaré avant les flux : il est détruit après leur arrêt
+    ar::WorkStealingPool pool(threads);
+    std::cout << "[INFO] Pool : " << pool.size() << " workers pour " << specs.size() << " flux\n";
+
+    std::vector<std::unique_ptr<ar::StreamProcessor>> streams;
+    for (std::size_t i = 0; i < specs.size(); ++i) {
+      const std::string name = "cam" + std::to_string(i);
+      auto stream = std::make_unique<ar::StreamProcessor>(name, openSource(specs[i].first, defaultFps),
+                                                          specs[i].second);
+      stream->start(pool);
+      std::cout << "[INFO] " << name << " : " << specs[i].first << " (" << stream->imageSize().width
+                << "x" << stream->imageSize().height << ", " << specs[i].second << ")\n";
+      streams.push_back(std::move(stream));
+    }
+
+    // === BOUCLE DE SUPERVISION : le travail est fait par le pool ===
+    const double t0 = io::monotonicSeconds();
+    double nextStats = t0 + statsInterval;
+    while (!interrupted) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      const double now = io::monotonicSeconds();
+
+      bool allFinished = true;
+      for (const auto& s : streams) allFinished = allFinished && s->finished();
+      if (allFinished || (duration > 0 && now - t0 >= duration)) break;
+
+      if (statsInterval > 0 && now >= nextStats) {
+        for (const auto& s : streams) printStats(*s, s->takeStats());
+        nextStats = now + statsInterval;
+      }
+    }
+
+    for (auto& s : streams) s->stop();
+    std::cout << "[INFO] Dernière fenêtre :\n";
+    for (const auto& s : streams) printStats(*s, s->takeStats());
+    const ar::WorkPoolStats ps = pool.stats();
+    std::cout << "[INFO] Pool : " << ps.executed << " tâches, dont " << ps.stolen << " volées\n";
+    streams.clear();
+  }
+  catch (const std::exception& e) {
+    std::cerr << "[ERREUR] " << e.what() << "\n";
+    return -1;
+  }
+  return 0;
+}
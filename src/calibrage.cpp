@@ -9,15 +9,34 @@
 #include <iomanip>
 #include <sstream>
 #include <cmath>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 enum class Mode { UNKNOWN=0, CHESS, A4 };
 
 // ---------- Damier (inchangé côté algo) ----------
+// Recherche sur une image réduite (plus grand côté <= CHESS_SEARCH_MAX) avec
+// FAST_CHECK : la plupart des frames échantillonnées n'ont pas de damier
+// exploitable et sont rejetées pour quelques ms. En cas de succès, les coins
+// sont remis à l'échelle puis raffinés sur l'image pleine résolution.
+static const int CHESS_SEARCH_MAX = 960;
+
 static bool detectChess(const cv::Mat& gray, cv::Size patternSize,
 std::vector<cv::Point2f>& corners)
 {
-    int flags = cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE;
-    if (!cv::findChessboardCorners(gray, patternSize, corners, flags)) return false;
+    int flags = cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE | cv::CALIB_CB_FAST_CHECK;
+    const double scale = std::min(1.0, (double)CHESS_SEARCH_MAX / std::max(gray.cols, gray.rows));
+    if (scale < 1.0) {
+    cv::Mat small;
+    cv::resize(gray, small, cv::Size(), scale, scale, cv::INTER_AREA);
+    if (!cv::findChessboardCorners(small, patternSize, corners, flags)) return false;
+    // centres de pixels : (x+0.5)/scale - 0.5
+    for (auto& c : corners) c = (c + cv::Point2f(0.5f, 0.5f)) * (float)(1.0/scale) - cv::Point2f(0.5f, 0.5f);
+    } else if (!cv::findChessboardCorners(gray, patternSize, corners, flags)) return false;
     cv::cornerSubPix(gray, corners, {11,11}, {-1,-1},
     {cv::TermCriteria::EPS+cv::TermCriteria::MAX_ITER, 30, 1e-3});
     return true;
@@ -60,6 +79,207 @@ static void orderQuad(std::vector<cv::Point2f>& q){ // TL,TR,BR,BL
     return true;
 }
 
+// ---------- Mode headless parallèle ----------
+// Chaque thread ouvre sa propre capture et traite des tranches de vidéo
+// (seek + décodage + détection) ; les vues sont choisies ensuite sur
+// l'ensemble des détections au lieu de garder les premières.
+struct Candidate {
+    int frame = 0;                   // index de frame (1 = première, comme idx)
+    Mode mode = Mode::UNKNOWN;
+    std::vector<cv::Point2f> pts;
+    double sharpness = 0.0;          // variance du laplacien sur la zone du motif
+};
+
+static double sharpnessIn(const cv::Mat& gray, const std::vector<cv::Point2f>& pts){
+    cv::Rect r = cv::boundingRect(pts) & cv::Rect(0, 0, gray.cols, gray.rows);
+    if (r.area() <= 0) return 0.0;
+    cv::Mat lap; cv::Laplacian(gray(r), lap, CV_64F);
+    cv::Scalar mu, sigma; cv::meanStdDev(lap, mu, sigma);
+    return sigma[0] * sigma[0];
+}
+
+static std::vector<Candidate> sampleParallel(const std::string& path, int step, cv::Size patternSize,
+                                             int threads, cv::Size& imageSize)
+{
+    cv::VideoCapture probe(path);
+    const int total = (int)probe.get(cv::CAP_PROP_FRAME_COUNT);
+    imageSize = cv::Size((int)probe.get(cv::CAP_PROP_FRAME_WIDTH), (int)probe.get(cv::CAP_PROP_FRAME_HEIGHT));
+    probe.release();
+
+    // Tranches de 32 frames échantillonnées ; nombre de frames inconnu => une seule tranche
+    const int chunkFrames = 32 * step;
+    const int nChunks = (total > 0) ? (total + chunkFrames - 1) / chunkFrames : 1;
+    if (total <= 0) threads = 1;
+
+    std::atomic<int> nextChunk{0};
+    std::mutex m;
+    std::vector<Candidate> out;
+
+    auto worker = [&](){
+        cv::VideoCapture cap(path);
+        if (!cap.isOpened()) return;
+        cv::Mat frame, gray;
+        int pos = 0; // prochaine frame que cap va décoder
+        for (int c = nextChunk++; c < nChunks; c = nextChunk++){
+            const int begin = c * chunkFrames;
+            const int end = (total > 0) ? std::min(total, begin + chunkFrames) : INT32_MAX;
+            if (pos != begin){ cap.set(cv::CAP_PROP_POS_FRAMES, begin); pos = begin; }
+            for (int f = begin; f < end; ++f){
+                if (!cap.grab()) break;
+                ++pos;
+                if ((f + 1) % step != 0) continue;      // même échantillonnage que idx % step
+                if (!cap.retrieve(frame) || frame.empty()) continue;
+                cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+
+                Candidate cand; cand.frame = f + 1;
+                if (detectChess(gray, patternSize, cand.pts)) cand.mode = Mode::CHESS;
+                else if (detectA4(frame, cand.pts)) cand.mode = Mode::A4;
+                else continue;
+                cand.sharpness = sharpnessIn(gray, cand.pts);
+
+                std::lock_guard<std::mutex> lk(m);
+                out.push_back(std::move(cand));
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < std::max(1, threads); ++t) pool.emplace_back(worker);
+    for (auto& th : pool) th.join();
+
+    std::sort(out.begin(), out.end(), [](const Candidate& a, const Candidate& b){ return a.frame < b.frame; });
+    return out;
+}
+
+// ---------- Sélection des vues ----------
+// Ensemble borné de vues : chaque nouvelle détection est comparée aux vues
+// gardées par un descripteur de pose apparente (position, échelle, rotation
+// et raccourcis perspectifs du quadrilatère extérieur du motif) et par la
+// couverture d'une grille 8x8 de l'image. Un quasi-doublon ne remplace son
+// voisin que s'il est plus net ; une fois l'ensemble plein, la vue la plus
+// redondante est remplacée si la nouvelle apporte plus de diversité.
+struct View {
+    int frame = 0;
+    std::vector<cv::Point2f> pts;
+    double sharpness = 0.0;
+    std::vector<int> cells;          // cases de la grille touchées
+    std::array<double,7> pose{};     // descripteur de pose apparente
+};
+
+class ViewSelector {
+public:
+    ViewSelector(int capacity, cv::Size imageSize, cv::Size pattern)
+        : cap_(capacity), size_(imageSize), pattern_(pattern), covered_(G*G, 0) {}
+
+    /// Propose une détection ; true si elle est gardée.
+    bool offer(int frame, const std::vector<cv::Point2f>& pts, double sharpness){
+        View v; v.frame = frame; v.pts = pts; v.sharpness = sharpness;
+        describe(v);
+
+        int nearest = -1; double dNew = nearestDist(v, -1, &nearest);
+        if (nearest >= 0 && dNew < DUP_EPS){
+            if (v.sharpness <= views_[nearest].sharpness) return false;
+            replace(nearest, std::move(v));
+            return true;
+        }
+        if ((int)views_.size() < cap_){
+            add(std::move(v));
+            return true;
+        }
+        int worst = -1; double worstScore = 1e30;
+        for (int i = 0; i < (int)views_.size(); ++i){
+            const double sc = score(views_[i], i);
+            if (sc < worstScore){ worstScore = sc; worst = i; }
+        }
+        // Score de la nouvelle vue mesuré contre l'ensemble privé de `worst`
+        uncover(views_[worst]);
+        const double newScore = nearestDist(v, worst, nullptr) + COVER_W * freshCells(v);
+        cover(views_[worst]);
+        if (newScore <= worstScore) return false;
+        replace(worst, std::move(v));
+        return true;
+    }
+
+    const std::vector<View>& views() const { return views_; }
+    int size() const { return (int)views_.size(); }
+    int coveredCells() const { return (int)std::count_if(covered_.begin(), covered_.end(), [](int c){ return c > 0; }); }
+
+private:
+    static constexpr int G = 8;
+    static constexpr double DUP_EPS = 0.05;   // en unités du descripteur
+    static constexpr double COVER_W = 0.02;   // poids d'une case nouvellement couverte
+
+    void describe(View& v) const {
+        const float W = (float)std::max(1, size_.width), H = (float)std::max(1, size_.height);
+        for (const auto& p : v.pts){
+            int gx = std::clamp((int)(p.x * G / W), 0, G-1);
+            int gy = std::clamp((int)(p.y * G / H), 0, G-1);
+            v.cells.push_back(gy * G + gx);
+        }
+        std::sort(v.cells.begin(), v.cells.end());
+        v.cells.erase(std::unique(v.cells.begin(), v.cells.end()), v.cells.end());
+
+        // Quadrilatère extérieur (4 coins du damier, ou l'A4 lui-même)
+        std::array<cv::Point2f,4> q;
+        if ((int)v.pts.size() == pattern_.area() && pattern_.area() > 4){
+            const int w = pattern_.width, n = (int)v.pts.size();
+            q = { v.pts[0], v.pts[w-1], v.pts[n-1], v.pts[n-w] };
+            // Le damier 6x9 peut être rendu dans les deux sens : on fixe le premier coin en haut à gauche
+            if (q[0].x + q[0].y > q[2].x + q[2].y) std::swap(q[0], q[2]), std::swap(q[1], q[3]);
+        } else {
+            q = { v.pts[0], v.pts[1], v.pts[2], v.pts[3] };
+        }
+        const cv::Point2f c = (q[0] + q[1] + q[2] + q[3]) * 0.25f;
+        const double top = cv::norm(q[1]-q[0]), bottom = cv::norm(q[2]-q[3]);
+        const double left = cv::norm(q[3]-q[0]), right = cv::norm(q[2]-q[1]);
+        const double area = std::abs(cv::contourArea(std::vector<cv::Point2f>(q.begin(), q.end())));
+        const double ang = 2.0 * std::atan2(q[1].y - q[0].y, q[1].x - q[0].x); // défini à 180° près
+        v.pose = { c.x / W, c.y / H,
+                   std::sqrt(area / (W * H)),
+                   0.25 * std::cos(ang), 0.25 * std::sin(ang),
+                   std::log((top + 1e-6) / (bottom + 1e-6)), std::log((left + 1e-6) / (right + 1e-6)) };
+    }
+
+    static double dist(const View& a, const View& b){
+        double d = 0.0;
+        for (size_t k = 0; k < a.pose.size(); ++k) d += (a.pose[k]-b.pose[k]) * (a.pose[k]-b.pose[k]);
+        return std::sqrt(d);
+    }
+
+    double nearestDist(const View& v, int skip, int* nearest) const {
+        double best = 1e30;
+        for (int i = 0; i < (int)views_.size(); ++i){
+            if (i == skip) continue;
+            const double d = dist(v, views_[i]);
+            if (d < best){ best = d; if (nearest) *nearest = i; }
+        }
+        return std::min(best, 1.0);
+    }
+
+    int freshCells(const View& v) const {
+        int n = 0;
+        for (int c : v.cells) n += covered_[c] == 0;
+        return n;
+    }
+
+    // Contribution d'une vue de l'ensemble : diversité + cases qu'elle est seule à couvrir
+    double score(const View& v, int i) const {
+        int own = 0;
+        for (int c : v.cells) own += covered_[c] == 1;
+        return nearestDist(v, i, nullptr) + COVER_W * own;
+    }
+
+    void cover(const View& v)  { for (int c : v.cells) ++covered_[c]; }
+    void uncover(const View& v){ for (int c : v.cells) --covered_[c]; }
+    void add(View v){ cover(v); views_.push_back(std::move(v)); }
+    void replace(int i, View v){ uncover(views_[i]); cover(v); views_[i] = std::move(v); }
+
+    int cap_;
+    cv::Size size_, pattern_;
+    std::vector<int> covered_;
+    std::vector<View> views_;
+};
+
 // ---------- HUD ----------
 static void drawHUD(cv::Mat& img, const std::string& l1, const std::string& l2, int kept, int maxV){
     int th=18, y=28;
@@ -111,11 +331,14 @@ static void drawHUD(cv::Mat& img, const std::string& l1, const std::string& l2,
     }
 
     static bool write_yaml_like_terminal(const std::string& path,
-    const cv::Mat& K, const cv::Mat& dist)
+    const cv::Mat& K, const cv::Mat& dist, cv::Size imageSize)
     {
     std::ofstream f(path, std::ios::binary);
     if (!f) return false;
     f << "%YAML:1.0\n";
+    // Résolution native : permet à ar::scaleCalibration d'adapter K à la capture
+    f << "image_width: " << imageSize.width << "\n";
+    f << "image_height: " << imageSize.height << "\n";
     write_opencv_matrix(f, "camera_matrix", K);
     write_opencv_matrix(f, "distortion_coefficients", dist);
     return true;
@@ -123,15 +346,37 @@ static void drawHUD(cv::Mat& img, const std::string& l1, const std::string& l2,
 
 // ---------- MAIN ----------
 int main(int argc, char** argv){
-    if (argc < 2) {
+    // --headless [--threads N] : sans fenêtre, échantillonnage parallèle de toute la vidéo
+    bool headless = false;
+    int frefWidth = 1280;   // largeur d'image à laquelle f_ref est donnée
+    int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> args;
+    auto usage = [&]{
     std::cerr << "Usage: " << (argc?argv[0]:"Camera")
-    << " <video.mp4> [step=5] [f_ref=885] [force_nominal=0]\n";
+    << " <video.mp4> [step=5] [f_ref=885] [force_nominal=0] [--headless] [--threads N] [--fref-width 1280]\n";
     return 1;
+    };
+    std::string videoPath;
+    int step = 5;
+    double fref = 885.0;     // focale nominale (px) à la largeur frefWidth
+    int forceNominal = 0;    // 1 => ignore la focale estimée
+    // Valeurs numériques invalides : message d'usage plutôt qu'une exception non rattrapée
+    try {
+    for (int i = 1; i < argc; ++i){
+    std::string a = argv[i];
+    if (a == "--headless") headless = true;
+    else if (a == "--threads" && i + 1 < argc) threads = std::max(1, std::stoi(argv[++i]));
+    else if (a == "--fref-width" && i + 1 < argc) frefWidth = std::max(1, std::stoi(argv[++i]));
+    else args.push_back(a);
+    }
+    if (args.empty()) return usage();
+    videoPath = args[0];
+    if (args.size()>=2) step = std::max(1, std::stoi(args[1]));   // step sert de modulo
+    if (args.size()>=3) fref = std::stod(args[2]);
+    if (args.size()>=4) forceNominal = std::stoi(args[3]);
+    } catch (const std::exception&) {
+    return usage();
     }
-    std::string videoPath = argv[1];
-    int step = (argc>=3)? std::stoi(argv[2]) : 5;
-    double fref = (argc>=4)? std::stod(argv[3]) : 885.0; // focale nominale pour 1280x720
-    int forceNominal = (argc>=5)? std::stoi(argv[4]) : 0; // 1 => ignore la focale estimée
 
     // Damier 
     cv::Size patternSize(6, 9);
@@ -149,10 +394,33 @@ int main(int argc, char** argv){
 
     int kept=0, idx=0, saved=0;
     Mode mode = Mode::UNKNOWN;
+    std::vector<View> views;   // vues finalement retenues
+
+    if (headless){
+    // Les threads se partagent déjà le travail : pas de parallélisme interne OpenCV
+    cv::setNumThreads(1);
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<Candidate> cands = sampleParallel(videoPath, step, patternSize, threads, imageSize);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // Damier prioritaire (comme en mode interactif) : si un damier est vu, on ignore les A4
+    const bool anyChess = std::any_of(cands.begin(), cands.end(), [](const Candidate& c){ return c.mode==Mode::CHESS; });
+    if (!cands.empty()) mode = anyChess ? Mode::CHESS : Mode::A4;
+    cands.erase(std::remove_if(cands.begin(), cands.end(), [&](const Candidate& c){ return c.mode != mode; }), cands.end());
+
+    ViewSelector selector(maxViews, imageSize, patternSize);
+    for (const auto& c : cands) selector.offer(c.frame, c.pts, c.sharpness);
+    views = selector.views();
+    std::cout << "Headless: " << cands.size() << " detections, " << views.size() << " vues retenues ("
+              << selector.coveredCells() << "/64 cases) en " << secs << " s (" << threads << " threads)\n";
+    cap.release();
+    } else {
 
     cv::namedWindow("Preview", cv::WINDOW_NORMAL);
     cv::resizeWindow("Preview", 960, 540);
     bool paused=false;
+    std::unique_ptr<ViewSelector> selector; // créé à la première image (taille connue)
+    int stale = 0;                          // détections refusées d'affilée, ensemble plein
 
     while (true){
     if(!paused){
@@ -171,31 +439,27 @@ int main(int argc, char** argv){
     std::vector<cv::Point2f> corners;
     ok = detectChess(gray, patternSize, corners);
     if (ok){
-    mode = Mode::CHESS; // === partie damier identique à ton code ===
-    std::vector<cv::Point3f> objp; objp.reserve(patternSize.area());
-    for(int j=0;j<patternSize.height;++j)
-    for(int i=0;i<patternSize.width;++i)
-    objp.emplace_back(i*squareSize, j*squareSize, 0.0f);
-    imgpoints.push_back(corners);
-    objpoints.push_back(objp);
-    ++kept; used=true;
+    mode = Mode::CHESS;
+    if (!selector) selector = std::make_unique<ViewSelector>(maxViews, imageSize, patternSize);
+    used = selector->offer(idx, corners, sharpnessIn(gray, corners));
     cv::drawChessboardCorners(display, patternSize, corners, true);
     }
     }
     if (!ok && (mode==Mode::UNKNOWN || mode==Mode::A4)){
     std::vector<cv::Point2f> quad;
     if (detectA4(frame, quad)){
+    ok = true;
     mode = Mode::A4;
-    imgpoints.push_back(quad);
-    objpoints.push_back({{0,0,0},{297,0,0},{297,210,0},{0,210,0}});
-    ++kept; used=true;
+    if (!selector) selector = std::make_unique<ViewSelector>(maxViews, imageSize, patternSize);
+    used = selector->offer(idx, quad, sharpnessIn(gray, quad));
     for(int i=0;i<4;++i) cv::line(display, quad[i], quad[(i+1)%4], cv::Scalar(0,255,0), 2);
     }
     }
     }
 
     std::string l1 = (mode==Mode::CHESS? "Damier 6x9" : (mode==Mode::A4? "A4" : "Recherche motif..."));
-    std::string l2 = used ? "DETECTION OK" : "(pas de detection cette frame)";
+    std::string l2 = used ? "VUE RETENUE" : (ok ? "DETECTION (vue redondante)" : "(pas de detection cette frame)");
+    kept = selector ? selector->size() : 0;
     drawHUD(display, l1, l2, kept, maxViews);
 
     cv::imshow("Preview", display);
@@ -206,10 +470,26 @@ int main(int argc, char** argv){
     std::string out=(p.parent_path()/(p.stem().string()+"_snap_"+std::to_string(saved++)+".png")).string();
     cv::imwrite(out, display); std::cout<<"snapshot: "<<out<<"\n"; }
 
-    if(kept>=maxViews) break;
+    // Ensemble plein et plus aucune vue nouvelle depuis longtemps : on arrête là
+    if (ok) stale = (used || kept < maxViews) ? 0 : stale + 1;
+    if (stale >= 3*maxViews) break;
     }
     cv::destroyWindow("Preview");
     cap.release();
+    if (selector) views = selector->views();
+    }
+
+    // -------- Correspondances 3D/2D des vues retenues --------
+    std::vector<cv::Point3f> objChess;
+    for(int j=0;j<patternSize.height;++j)
+    for(int i=0;i<patternSize.width;++i)
+    objChess.emplace_back(i*squareSize, j*squareSize, 0.0f);
+    for (const auto& v : views){
+    imgpoints.push_back(v.pts);
+    if (mode==Mode::CHESS) objpoints.push_back(objChess);
+    else objpoints.push_back({{0,0,0},{297,0,0},{297,210,0},{0,210,0}});
+    }
+    kept = (int)views.size();
 
     if (mode==Mode::UNKNOWN){
     std::cerr << "ERR: aucun motif détecté (ni damier ni A4)\n";
@@ -222,9 +502,12 @@ int main(int argc, char** argv){
     K_yaml.at<double>(1,2) = imageSize.height * 0.5;
     cv::Mat dist_yaml = cv::Mat::zeros(1,5,CV_64F);
 
-    // focale nominale mise à l'échelle
-    const double fx_nom = fref * ((double)imageSize.width / 1280.0);
-    const double fy_nom = fref * ((double)imageSize.height / 720.0);
+    // focale nominale mise à l'échelle : facteur unique (pixels carrés), pris sur
+    // la largeur ; l'ancien facteur séparé en y faussait fy dès que le rapport
+    // d'aspect n'était pas 16:9 (ex. 1440x1080 : fy = 1.5 * fx)
+    const double fscale = (double)imageSize.width / frefWidth;
+    const double fx_nom = fref * fscale;
+    const double fy_nom = fref * fscale;
 
     auto pick_focal = [](double f_est, double f_nom)->double{
     if (!std::isfinite(f_est)) return f_nom;
@@ -233,11 +516,34 @@ int main(int argc, char** argv){
     return f_est;
     };
 
-    if (mode==Mode::CHESS && kept >= 8 && !forceNominal){
+    if (mode==Mode::CHESS && kept >= minViews && !forceNominal){
     // == EXACTEMENT le bloc de calibration damier ==
     cv::Mat K, dist; std::vector<cv::Mat> rvecs, tvecs;
     int flags = cv::CALIB_FIX_K3 | cv::CALIB_FIX_K4 | cv::CALIB_FIX_K5 | cv::CALIB_FIX_K6;
-    double rms = cv::calibrateCamera(objpoints, imgpoints, imageSize, K, dist, rvecs, tvecs, flags);
+    cv::Mat stdIn, stdEx, perView;
+    double rms = cv::calibrateCamera(objpoints, imgpoints, imageSize, K, dist, rvecs, tvecs,
+    stdIn, stdEx, perView, flags);
+
+    // Élagage : vues dont l'erreur de reprojection dépasse 2x la médiane (et 1 px)
+    std::vector<double> errs((size_t)perView.total());
+    for (size_t i = 0; i < errs.size(); ++i) errs[i] = perView.at<double>((int)i);
+    std::vector<double> sorted = errs; std::sort(sorted.begin(), sorted.end());
+    const double limit = std::max(1.0, 2.0 * sorted[sorted.size()/2]);
+    std::vector<int> outliers;
+    for (size_t i = 0; i < errs.size(); ++i){
+    std::cout << "  vue " << std::setw(2) << i << " (frame " << views[i].frame << ") RMS = " << errs[i]
+              << (errs[i] > limit ? "  -> rejetee" : "") << "\n";
+    if (errs[i] > limit) outliers.push_back((int)i);
+    }
+    if (!outliers.empty() && kept - (int)outliers.size() >= minViews){
+    for (auto it = outliers.rbegin(); it != outliers.rend(); ++it){
+    objpoints.erase(objpoints.begin() + *it);
+    imgpoints.erase(imgpoints.begin() + *it);
+    }
+    kept = (int)objpoints.size();
+    rms = cv::calibrateCamera(objpoints, imgpoints, imageSize, K, dist, rvecs, tvecs, flags);
+    std::cout << outliers.size() << " vue(s) rejetee(s), recalibration sur " << kept << " vues\n";
+    }
     std::cout << "RMS Error = " << rms << "\n";
     std::cout << "Image size = " << imageSize.width << " x " << imageSize.height << "\n";
     std::cout << "K =\n" << K << "\n";
@@ -259,7 +565,7 @@ int main(int argc, char** argv){
     std::filesystem::path out = in.parent_path() / (in.stem().string() + ".yaml");
 
     // Écriture "propre" sans --- et sans notation scientifique
-    if (!write_yaml_like_terminal(out.string(), K_yaml, dist_yaml)) {
+    if (!write_yaml_like_terminal(out.string(), K_yaml, dist_yaml, imageSize)) {
     std::cerr << "ERR: cannot open " << out << " for write\n";
     return -4;
     }
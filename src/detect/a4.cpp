@@ -1,5 +1,7 @@
 #include "detect/a4.hpp"
+#include "detect/blob.hpp"
 #include <opencv2/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
 #include <algorithm>
 #include <cmath>
 #include <vector>
@@ -7,11 +9,7 @@
 
 namespace detect {
 
-// --- VARIABLES STATIQUES ---
-static std::vector<cv::Point2f> prevCorners;
-static bool hasTracking = false;
-// Compteur pour garder l'affichage quelques frames si on perd la détection (anti-clignotement)
-static int lostFramesCount = 0; 
+// Nombre de frames pendant lesquelles on garde l'affichage si on perd la détection (anti-clignotement)
 const int MAX_LOST_FRAMES = 5; 
 
 // Distance au carré
@@ -51,6 +49,7 @@ bool orderFourCornersGeometric(const std::vector<cv::Point>& approx,
 
 // --- TRI PAR TRACKING ---
 bool orderCornersTracking(const std::vector<cv::Point>& approx,
+                          const std::vector<cv::Point2f>& prevCorners,
                           std::vector<cv::Point2f>& ordered)
 {
     if (approx.size() != 4) return false;
@@ -77,15 +76,41 @@ bool orderCornersTracking(const std::vector<cv::Point>& approx,
     return true;
 }
 
-// --- DÉTECTION PRINCIPALE ---
-bool detectA4Corners(const cv::Mat& frameBGR, std::vector<cv::Point2f>& imagePts) {
-  
-  // 1. Pré-traitement
-  cv::Mat gray, blurred, thresh;
+// --- PERSISTANCE ---
+// Si on perd le tracking, on garde l'ancienne position quelques frames (persistance rétinienne)
+bool A4Tracker::holdPrevious(std::vector<cv::Point2f>& imagePts) {
+  if (hasTracking_ && lostFramesCount_ < MAX_LOST_FRAMES) {
+      imagePts = prevCorners_;
+      lostFramesCount_++;
+      return true;
+  }
+  hasTracking_ = false;
+  return false;
+}
+
+void A4Tracker::reset() {
+  prevCorners_.clear();
+  hasTracking_ = false;
+  lostFramesCount_ = 0;
+}
+
+// --- DÉTECTION PRINCIPALE (BGR) ---
+bool A4Tracker::detect(const cv::Mat& frameBGR, std::vector<cv::Point2f>& imagePts) {
+  cv::Mat gray;
   cv::cvtColor(frameBGR, gray, cv::COLOR_BGR2GRAY);
+  return detectLuma(gray, imagePts, 1);
+}
+
+// --- DÉTECTION PRINCIPALE (Luminance) ---
+bool A4Tracker::detectLuma(const cv::Mat& luma, std::vector<cv::Point2f>& imagePts, int denom) {
+  CV_Assert(luma.type() == CV_8UC1);
+  if (denom < 1) denom = 1;
+
+  // 1. Pré-traitement
+  cv::Mat blurred;
   
   // Flou léger pour enlever le bruit caméra
-  cv::GaussianBlur(gray, blurred, cv::Size(5,5), 0);
+  cv::GaussianBlur(luma, blurred, cv::Size(5,5), 0);
 
   // 2. Otsu Robuste
   const int H = blurred.rows, W = blurred.cols;
@@ -97,52 +122,27 @@ bool detectA4Corners(const cv::Mat& frameBGR, std::vector<cv::Point2f>& imagePts
   double calculatedT = cv::threshold(roiImg, tempThresh, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
   if (calculatedT < 40.0) calculatedT = 40.0; // Sécurité ambiance sombre
   
-  cv::threshold(blurred, thresh, calculatedT, 255, cv::THRESH_BINARY);
+  // Masque 1 bit par pixel directement (8x moins de mémoire, morphologie par mots de 64 pixels)
+  thresholdToBits(blurred, calculatedT, mask_);
 
   // --- AMÉLIORATION MAJEURE : MORPHOLOGIE ---
   // C'est ICI qu'on gère le mouvement rapide.
   // "Dilater" puis "Eroder" (Close) va reconnecter les lignes brisées par le flou de bougé.
-  cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(5, 5));
-  cv::morphologyEx(thresh, thresh, cv::MORPH_CLOSE, kernel); 
+  const cv::Size kernel(5, 5);
+  closeRect(mask_, mask_, kernel);
   // On dilate un peu pour "engraisser" les contours fins
-  cv::dilate(thresh, thresh, kernel);
-
-  // 3. Contours
-  std::vector<std::vector<cv::Point>> contours;
-  cv::findContours(thresh, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-  if (contours.empty()) { 
-      // Si on perd le tracking, on garde l'ancienne position quelques frames (persistance rétinienne)
-      if (hasTracking && lostFramesCount < MAX_LOST_FRAMES) {
-          imagePts = prevCorners;
-          lostFramesCount++;
-          return true;
-      }
-      hasTracking = false; return false; 
-  }
+  dilateRect(mask_, mask_, kernel);
 
-  // Trouver le plus grand contour
-  double maxA = 0; int maxIdx = -1;
-  for (int i = 0; i < (int)contours.size(); ++i){
-    const double A = std::fabs(cv::contourArea(contours[i]));
-    if (A > maxA && A > (W*H*0.02)){ // Doit faire au moins 2% de l'image
-        maxA = A; maxIdx = i; 
-    }
-  }
-  
-  if (maxIdx < 0) { 
-       if (hasTracking && lostFramesCount < MAX_LOST_FRAMES) {
-          imagePts = prevCorners;
-          lostFramesCount++;
-          return true;
-      }
-      hasTracking = false; return false; 
-  }
+  // 3. Contour de la plus grande tache seulement (les autres ne sont jamais détourées)
+  std::vector<cv::Point> contour;
+  if (!largestBlobContour(mask_, W*H*0.02, contour)) // Doit faire au moins 2% de l'image
+    return holdPrevious(imagePts);
 
   // --- AMÉLIORATION MAJEURE : CONVEX HULL ---
   // Si le mouvement est flou, le contour est dentelé.
   // ConvexHull crée une enveloppe lisse autour (comme un élastique), ce qui redonne 4 coins propres.
   std::vector<cv::Point> hull;
-  cv::convexHull(contours[maxIdx], hull);
+  cv::convexHull(contour, hull);
 
   std::vector<cv::Point> approx;
   // Approximation polygonale sur le Hull, pas sur le contour brut !
@@ -155,42 +155,84 @@ bool detectA4Corners(const cv::Mat& frameBGR, std::vector<cv::Point2f>& imagePts
       cv::approxPolyDP(hull, approx, eps, true);
   }
 
-  if (approx.size() != 4) { 
-       if (hasTracking && lostFramesCount < MAX_LOST_FRAMES) {
-          imagePts = prevCorners;
-          lostFramesCount++;
-          return true;
-      }
-      hasTracking = false; return false; 
+  if (approx.size() != 4) return holdPrevious(imagePts);
+
+  // Luminance réduite : on revient en coordonnées pleine résolution
+  // (le centre du pixel i réduit est en (i + 0.5) * denom - 0.5)
+  if (denom > 1) {
+    for (auto& p : approx) {
+      p.x = (int)std::lround((p.x + 0.5) * denom - 0.5);
+      p.y = (int)std::lround((p.y + 0.5) * denom - 0.5);
+    }
   }
 
   // 4. Tri et Validation
   bool ok = false;
 
-  if (hasTracking) {
-      ok = orderCornersTracking(approx, imagePts);
+  if (hasTracking_) {
+      ok = orderCornersTracking(approx, prevCorners_, imagePts);
       if (!ok) ok = orderFourCornersGeometric(approx, imagePts);
   } else {
       ok = orderFourCornersGeometric(approx, imagePts);
   }
 
   if (ok) {
-      prevCorners = imagePts;
-      hasTracking = true;
-      lostFramesCount = 0; // Reset du compteur de perte
+      prevCorners_ = imagePts;
+      hasTracking_ = true;
+      lostFramesCount_ = 0; // Reset du compteur de perte
   } else {
       // Si le tri échoue mais qu'on avait un tracking, on temporise
-      if (hasTracking && lostFramesCount < MAX_LOST_FRAMES) {
-          imagePts = prevCorners;
-          lostFramesCount++;
-          return true;
-      }
-      hasTracking = false;
+      return holdPrevious(imagePts);
   }
 
   return ok;
 }
 
+// --- SUIVI SEUL (flux optique) ---
+bool A4Tracker::track(const cv::Mat& prevLuma, const cv::Mat& luma, std::vector<cv::Point2f>& imagePts, int denom) {
+  if (!hasTracking_ || prevCorners_.size() != 4 || prevLuma.size() != luma.size()) return false;
+  if (denom < 1) denom = 1;
+
+  // Coins pleine résolution -> repère de la luminance réduite (centres de pixels)
+  std::vector<cv::Point2f> prev(4), next;
+  for (int i = 0; i < 4; ++i)
+    prev[i] = (prevCorners_[i] + cv::Point2f(0.5f, 0.5f)) * (1.0f / denom) - cv::Point2f(0.5f, 0.5f);
+
+  std::vector<unsigned char> status;
+  std::vector<float> err;
+  cv::calcOpticalFlowPyrLK(prevLuma, luma, prev, next, status, err, cv::Size(21, 21), 3);
+  for (int i = 0; i < 4; ++i)
+    if (!status[i]) return false;
+
+  std::vector<cv::Point2f> pts(4);
+  for (int i = 0; i < 4; ++i)
+    pts[i] = (next[i] + cv::Point2f(0.5f, 0.5f)) * (float)denom - cv::Point2f(0.5f, 0.5f);
+
+  // Le quadrilatère doit rester convexe et d'aire comparable
+  const double a0 = std::fabs(cv::contourArea(prevCorners_));
+  const double a1 = std::fabs(cv::contourArea(pts));
+  if (!cv::isContourConvex(pts) || a1 < 0.8 * a0 || a1 > 1.25 * a0) return false;
+
+  prevCorners_ = pts;
+  lostFramesCount_ = 0;
+  imagePts = pts;
+  return true;
+}
+
+// Tracker partagé par les fonctions libres (compatibilité)
+static A4Tracker& defaultTracker() {
+  static A4Tracker tracker;
+  return tracker;
+}
+
+bool detectA4Corners(const cv::Mat& frameBGR, std::vector<cv::Point2f>& imagePts) {
+  return defaultTracker().detect(frameBGR, imagePts);
+}
+
+bool detectA4CornersLuma(const cv::Mat& luma, std::vector<cv::Point2f>& imagePts, int denom) {
+  return defaultTracker().detectLuma(luma, imagePts, denom);
+}
+
 void drawOrderedCorners(cv::Mat& img, const std::vector<cv::Point2f>& pts) {
   if (pts.size() != 4) return;
   const cv::Scalar colors[4] = {{0,0,255}, {0,255,255}, {255,0,0}, {0,255,0}}; // TL, BL, BR, TR
@@ -0,0 +1,142 @@
+#include "detect/bitmask.hpp"
+#include <algorithm>
+#include <cmath>
+
+// AR_NO_SIMD : force le chemin scalaire (test de référence sans SSE2)
+#if defined(__SSE2__) && !defined(AR_NO_SIMD)
+#define AR_BITMASK_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace detect {
+
+void BitMask::create(int width, int height) {
+  CV_Assert(width >= 0 && height >= 0);
+  width_ = width;
+  height_ = height;
+  words_ = (width + 63) / 64;
+  bits_.resize((std::size_t)words_ * height);
+}
+
+cv::Mat BitMask::toMat() const {
+  cv::Mat m(height_, width_, CV_8UC1);
+  for (int y = 0; y < height_; ++y) {
+    unsigned char* d = m.ptr<unsigned char>(y);
+    for (int x = 0; x < width_; ++x) d[x] = get(x, y) ? 255 : 0;
+  }
+  return m;
+}
+
+void thresholdToBits(const cv::Mat& src, double thresh, BitMask& dst) {
+  CV_Assert(src.type() == CV_8UC1);
+  dst.create(src.cols, src.rows);
+  // Même arrondi que cv::threshold sur 8 bits : v > floor(thresh)
+  const int t = std::min(255, std::max(-1, (int)std::floor(thresh)));
+  const int W = src.cols;
+
+  for (int y = 0; y < src.rows; ++y) {
+    const unsigned char* s = src.ptr<unsigned char>(y);
+    std::uint64_t* d = dst.row(y);
+    int x = 0;
+#if defined(AR_BITMASK_SSE2)
+    if (t >= 0 && t < 255) {
+      // Comparaison non signée via le biais 0x80 ; 16 pixels -> 16 bits par movemask
+      const __m128i bias = _mm_set1_epi8((char)0x80);
+      const __m128i vt = _mm_set1_epi8((char)(t ^ 0x80));
+      for (; x + 64 <= W; x += 64) {
+        std::uint64_t w = 0;
+        for (int k = 0; k < 4; ++k) {
+          const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + x + 16 * k));
+          const __m128i gt = _mm_cmpgt_epi8(_mm_xor_si128(v, bias), vt);
+          w |= (std::uint64_t)(unsigned)_mm_movemask_epi8(gt) << (16 * k);
+        }
+        d[x >> 6] = w;
+      }
+    }
+#endif
+    for (; x < W; x += 64) {
+      const int n = std::min(64, W - x);
+      std::uint64_t w = 0;
+      for (int i = 0; i < n; ++i) w |= (std::uint64_t)(s[x + i] > t) << i;
+      d[x >> 6] = w;
+    }
+  }
+}
+
+namespace {
+
+// Tampon intermédiaire entre les deux passes (un par thread : détection multi-flux)
+std::vector<std::uint64_t>& scratch(std::size_t n) {
+  thread_local std::vector<std::uint64_t> buf;
+  if (buf.size() < n) buf.resize(n);
+  return buf;
+}
+
+/**
+ * Passe horizontale : out(x) = OP_{i} in(x + i - anchor), i dans [0, k).
+ * fill = valeur des pixels hors image (0 dilatation, ~0 érosion).
+ */
+template <bool Dilate>
+void horizontalPass(const std::uint64_t* in, std::uint64_t* out, int words,
+                    std::uint64_t lastMask, int k) {
+  const std::uint64_t fill = Dilate ? 0ull : ~0ull;
+  const int anchor = k / 2;
+  // Pixels au-delà de la largeur : hors image
+  auto word = [&](int i) -> std::uint64_t {
+    if (i < 0 || i >= words) return fill;
+    return i == words - 1 ? ((in[i] & lastMask) | (fill & ~lastMask)) : in[i];
+  };
+  for (int i = 0; i < words; ++i) {
+    const std::uint64_t prev = word(i - 1), cur = word(i), next = word(i + 1);
+    std::uint64_t acc = cur;
+    for (int j = 0; j < k; ++j) {
+      const int s = j - anchor;   // lecture du pixel x + s
+      if (s == 0) continue;
+      std::uint64_t v;
+      if (s > 0) v = (cur >> s) | (next << (64 - s));
+      else       v = (cur << -s) | (prev >> (64 + s));
+      acc = Dilate ? (acc | v) : (acc & v);
+    }
+    out[i] = acc;
+  }
+}
+
+template <bool Dilate>
+void morphRect(const BitMask& src, BitMask& dst, cv::Size ksize) {
+  CV_Assert(ksize.width >= 1 && ksize.height >= 1 && ksize.width <= 64);
+  const int W = src.width(), H = src.height(), words = src.wordsPerRow();
+  const std::uint64_t lastMask = src.lastWordMask();
+  std::vector<std::uint64_t>& tmp = scratch((std::size_t)words * H);
+
+  for (int y = 0; y < H; ++y)
+    horizontalPass<Dilate>(src.row(y), tmp.data() + (std::size_t)y * words, words, lastMask, ksize.width);
+
+  // Passe verticale : OU / ET des lignes [y - anchor, y - anchor + k) ; hors image
+  // ces lignes sont neutres (0 pour OU, 1 pour ET), on les saute
+  dst.create(W, H);
+  const int anchor = ksize.height / 2;
+  for (int y = 0; y < H; ++y) {
+    std::uint64_t* d = dst.row(y);
+    const int y0 = std::max(0, y - anchor), y1 = std::min(H, y - anchor + ksize.height);
+    const std::uint64_t* r = tmp.data() + (std::size_t)y0 * words;
+    std::copy(r, r + words, d);
+    for (int yy = y0 + 1; yy < y1; ++yy) {
+      r = tmp.data() + (std::size_t)yy * words;
+      for (int i = 0; i < words; ++i) d[i] = Dilate ? (d[i] | r[i]) : (d[i] & r[i]);
+    }
+    if (words) d[words - 1] &= lastMask;
+  }
+}
+
+} // namespace
+
+void dilateRect(const BitMask& src, BitMask& dst, cv::Size ksize) { morphRect<true>(src, dst, ksize); }
+
+void erodeRect(const BitMask& src, BitMask& dst, cv::Size ksize) { morphRect<false>(src, dst, ksize); }
+
+void closeRect(const BitMask& src, BitMask& dst, cv::Size ksize) {
+  dilateRect(src, dst, ksize);
+  erodeRect(dst, dst, ksize);
+}
+
+} // namespace detect
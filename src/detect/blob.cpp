@@ -0,0 +1,218 @@
+#include "detect/blob.hpp"
+#include "detect/bitmask.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+namespace detect {
+
+namespace {
+
+// Segment horizontal [x0, x1) de pixels allumés, avec son étiquette provisoire
+struct Run { int x0, x1, label; };
+
+// Étiquette provisoire : union-find + statistiques propres, repliées sur la racine à la fin
+struct Label {
+  int parent;
+  long area;
+  int minX, minY, maxX, maxY;
+  int startX, startY;
+};
+
+int findRoot(std::vector<Label>& labels, int i) {
+  while (labels[i].parent != i) {
+    labels[i].parent = labels[labels[i].parent].parent;   // compression par moitié
+    i = labels[i].parent;
+  }
+  return i;
+}
+
+void unite(std::vector<Label>& labels, int a, int b) {
+  a = findRoot(labels, a);
+  b = findRoot(labels, b);
+  if (a == b) return;
+  // La plus petite étiquette (créée en premier) reste racine
+  if (b < a) std::swap(a, b);
+  labels[b].parent = a;
+}
+
+// Directions dans le sens horaire (y vers le bas) : E, SE, S, SO, O, NO, N, NE
+const int DX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+const int DY[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// Accès aux masques : segments d'une ligne et test d'un pixel
+struct ByteRows {
+  const cv::Mat& m;
+  int width() const { return m.cols; }
+  int height() const { return m.rows; }
+  bool on(int x, int y) const { return m.ptr<std::uint8_t>(y)[x] != 0; }
+  template <class Emit> void runs(int y, Emit emit) const {
+    const std::uint8_t* row = m.ptr<std::uint8_t>(y);
+    const int W = m.cols;
+    int x = 0;
+    while (x < W) {
+      while (x < W && row[x] == 0) ++x;
+      if (x == W) break;
+      const int x0 = x;
+      while (x < W && row[x] != 0) ++x;
+      emit(x0, x);
+    }
+  }
+};
+
+struct BitRows {
+  const BitMask& m;
+  int width() const { return m.width(); }
+  int height() const { return m.height(); }
+  bool on(int x, int y) const { return m.get(x, y); }
+  // Prochain bit à `set` à partir de x (64 pixels par mot testé)
+  static int next(const std::uint64_t* r, int words, int x, bool set) {
+    int i = x >> 6;
+    if (i >= words) return words * 64;
+    std::uint64_t w = (set ? r[i] : ~r[i]) & (~0ull << (x & 63));
+    while (!w) {
+      if (++i == words) return words * 64;
+      w = set ? r[i] : ~r[i];
+    }
+    return i * 64 + __builtin_ctzll(w);
+  }
+  template <class Emit> void runs(int y, Emit emit) const {
+    const std::uint64_t* r = m.row(y);
+    const int W = m.width(), words = m.wordsPerRow();
+    int x = 0;
+    for (;;) {
+      x = next(r, words, x, true);
+      if (x >= W) break;
+      const int x0 = x;
+      x = std::min(W, next(r, words, x, false));   // bits au-delà de la largeur : nuls
+      emit(x0, x);
+    }
+  }
+};
+
+/**
+ * Suivi de bord de Moore depuis le premier pixel (haut-gauche) d'une
+ * composante : les pixels des autres composantes ne sont jamais 8-voisins
+ * du bord suivi, le masque seul suffit.
+ */
+template <class Mask>
+void traceOuterBorder(const Mask& mask, cv::Point p0, std::vector<cv::Point>& contour) {
+  const int W = mask.width(), H = mask.height();
+  auto on = [&](int x, int y) {
+    return x >= 0 && y >= 0 && x < W && y < H && mask.on(x, y);
+  };
+
+  // Premier pas : on arrive de l'ouest (fond), recherche à partir du nord-ouest
+  auto step = [&](cv::Point p, int from) {
+    for (int k = 0; k < 8; ++k) {
+      const int d = (from + k) & 7;
+      if (on(p.x + DX[d], p.y + DY[d])) return d;
+    }
+    return -1;
+  };
+
+  std::vector<cv::Point> pts;
+  std::vector<std::uint8_t> dirs;
+  int d = step(p0, 5);
+  if (d < 0) { contour.assign(1, p0); return; }   // pixel isolé
+
+  const cv::Point p1(p0.x + DX[d], p0.y + DY[d]);
+  cv::Point p = p0;
+  for (;;) {
+    pts.push_back(p);
+    dirs.push_back((std::uint8_t)d);
+    p = cv::Point(p.x + DX[d], p.y + DY[d]);
+    // Reprise juste après le dernier voisin de fond examiné
+    d = step(p, (d & 1) ? d + 6 : d + 7);
+    // Fin quand on repart de p0 vers p1 (critère de Suzuki)
+    if (p == p0 && cv::Point(p.x + DX[d], p.y + DY[d]) == p1) break;
+  }
+
+  // Compression : seuls les sommets où la direction change (CHAIN_APPROX_SIMPLE)
+  contour.clear();
+  const std::size_t n = pts.size();
+  for (std::size_t i = 0; i < n; ++i)
+    if (dirs[i] != dirs[(i + n - 1) % n]) contour.push_back(pts[i]);
+  if (contour.empty()) contour.push_back(p0);
+}
+
+template <class Mask>
+bool largestBlob(const Mask& mask, double minArea, std::vector<cv::Point>& contour, BlobStats* stats) {
+  const int H = mask.height();
+
+  std::vector<Label> labels;
+  std::vector<Run> prev, cur;
+  labels.reserve(256);
+  prev.reserve(64);
+  cur.reserve(64);
+
+  for (int y = 0; y < H; ++y) {
+    cur.clear();
+    std::size_t j = 0;   // premier segment de la ligne précédente encore susceptible de toucher
+    mask.runs(y, [&](int x0, int x1) {
+      // 8-connexité : [x0-1, x1] recouvre un segment de la ligne précédente
+      int label = -1;
+      while (j < prev.size() && prev[j].x1 < x0) ++j;
+      for (std::size_t k = j; k < prev.size() && prev[k].x0 <= x1; ++k) {
+        if (label < 0) label = prev[k].label;
+        else unite(labels, label, prev[k].label);
+      }
+      if (label < 0) {
+        label = (int)labels.size();
+        labels.push_back({label, 0, INT_MAX, INT_MAX, -1, -1, x0, y});
+      }
+      Label& l = labels[label];
+      l.area += x1 - x0;
+      l.minX = std::min(l.minX, x0);
+      l.maxX = std::max(l.maxX, x1 - 1);
+      l.minY = std::min(l.minY, y);
+      l.maxY = y;
+      cur.push_back({x0, x1, label});
+    });
+    std::swap(prev, cur);
+  }
+
+  // Repli des statistiques sur les racines ; l'étiquette racine est la plus
+  // ancienne, son premier pixel est donc le premier de la composante
+  int best = -1;
+  for (int i = (int)labels.size() - 1; i >= 0; --i) {
+    const int r = findRoot(labels, i);
+    if (r != i) {
+      Label& R = labels[r];
+      const Label& L = labels[i];
+      R.area += L.area;
+      R.minX = std::min(R.minX, L.minX);
+      R.minY = std::min(R.minY, L.minY);
+      R.maxX = std::max(R.maxX, L.maxX);
+      R.maxY = std::max(R.maxY, L.maxY);
+    }
+  }
+  for (int i = 0; i < (int)labels.size(); ++i)
+    if (labels[i].parent == i && (best < 0 || labels[i].area > labels[best].area)) best = i;
+
+  if (best < 0 || labels[best].area <= minArea) return false;
+
+  const Label& b = labels[best];
+  traceOuterBorder(mask, cv::Point(b.startX, b.startY), contour);
+  if (stats) {
+    stats->area = (double)b.area;
+    stats->bbox = cv::Rect(b.minX, b.minY, b.maxX - b.minX + 1, b.maxY - b.minY + 1);
+    stats->start = cv::Point(b.startX, b.startY);
+  }
+  return true;
+}
+
+} // namespace
+
+bool largestBlobContour(const cv::Mat& mask, double minArea,
+                        std::vector<cv::Point>& contour, BlobStats* stats) {
+  CV_Assert(mask.type() == CV_8UC1);
+  return largestBlob(ByteRows{mask}, minArea, contour, stats);
+}
+
+bool largestBlobContour(const BitMask& mask, double minArea,
+                        std::vector<cv::Point>& contour, BlobStats* stats) {
+  return largestBlob(BitRows{mask}, minArea, contour, stats);
+}
+
+} // namespace detect
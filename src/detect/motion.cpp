@@ -0,0 +1,77 @@
+#include "detect/motion.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace detect {
+
+// Somme des différences absolues d'un bloc BLOCK_W x BLOCK_H (pas de ligne = THUMB_W)
+static int blockSAD(const unsigned char* a, const unsigned char* b) {
+#if defined(__SSE2__)
+  static_assert(MotionGate::BLOCK_W == 8, "une ligne de bloc = un chargement de 64 bits");
+  __m128i s = _mm_setzero_si128();
+  for (int y = 0; y < MotionGate::BLOCK_H; ++y) {
+    const __m128i va = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + y * MotionGate::THUMB_W));
+    const __m128i vb = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + y * MotionGate::THUMB_W));
+    s = _mm_add_epi64(s, _mm_sad_epu8(va, vb));
+  }
+  return _mm_cvtsi128_si32(s);
+#else
+  int s = 0;
+  for (int y = 0; y < MotionGate::BLOCK_H; ++y)
+    for (int x = 0; x < MotionGate::BLOCK_W; ++x)
+      s += std::abs(a[y * MotionGate::THUMB_W + x] - b[y * MotionGate::THUMB_W + x]);
+  return s;
+#endif
+}
+
+bool MotionGate::isStatic(const cv::Mat& luma, int denom, const std::vector<cv::Point2f>& quad) {
+  CV_Assert(luma.type() == CV_8UC1);
+  if (denom < 1) denom = 1;
+  ++total_;
+  if (cfg_.refreshInterval <= 0) return false;
+
+  cv::resize(luma, thumb_, cv::Size(THUMB_W, THUMB_H), 0, 0, cv::INTER_AREA);
+
+  // Blocs à comparer : ceux du quadrilatère élargi de sa marge, sinon toute l'image
+  constexpr int BX = THUMB_W / BLOCK_W, BY = THUMB_H / BLOCK_H;
+  int bx0 = 0, by0 = 0, bx1 = BX, by1 = BY;
+  if (quad.size() == 4) {
+    const cv::Rect box = cv::boundingRect(quad);
+    const float mx = cfg_.margin * box.width, my = cfg_.margin * box.height;
+    const float sx = (float)THUMB_W / (luma.cols * denom), sy = (float)THUMB_H / (luma.rows * denom);
+    bx0 = std::max(0,  (int)std::floor((box.x - mx) * sx / BLOCK_W));
+    by0 = std::max(0,  (int)std::floor((box.y - my) * sy / BLOCK_H));
+    bx1 = std::min(BX, (int)std::ceil((box.x + box.width  + mx) * sx / BLOCK_W));
+    by1 = std::min(BY, (int)std::ceil((box.y + box.height + my) * sy / BLOCK_H));
+  }
+
+  bool same = !ref_.empty() && reused_ < cfg_.refreshInterval && bx0 < bx1 && by0 < by1;
+  const int maxSAD = (int)(cfg_.threshold * BLOCK_W * BLOCK_H);
+  for (int by = by0; same && by < by1; ++by)
+    for (int bx = bx0; bx < bx1; ++bx) {
+      const int off = by * BLOCK_H * THUMB_W + bx * BLOCK_W;
+      if (blockSAD(thumb_.data + off, ref_.data + off) > maxSAD) { same = false; break; }
+    }
+
+  if (same) {
+    ++reused_;
+    ++skipped_;
+    return true;
+  }
+  // Nouvelle référence : l'image qui va être réellement traitée
+  std::swap(thumb_, ref_);
+  reused_ = 0;
+  return false;
+}
+
+void MotionGate::reset() {
+  ref_.release();
+  reused_ = 0;
+}
+
+} // namespace detect
@@ -0,0 +1,50 @@
+#include "glx/ballbatch.hpp"
+#include <algorithm>
+#include <cstddef>
+
+namespace glx {
+
+BallBatch::BallBatch() {
+  GLuint vao = 0, vbo = 0;
+  glGenVertexArrays(1, &vao);
+  glGenBuffers(1, &vbo);
+  vao_.reset(vao);
+  vbo_.reset(vbo);
+
+  glBindVertexArray(vao);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  const GLsizei stride = sizeof(BallInstance);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BallInstance, center));
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BallInstance, radius));
+  // mat3 : une location par colonne
+  for (GLuint c = 0; c < 3; ++c) {
+    glEnableVertexAttribArray(2 + c);
+    glVertexAttribPointer(2 + c, 3, GL_FLOAT, GL_FALSE, stride,
+                          (void*)(offsetof(BallInstance, rotation) + c * 3 * sizeof(float)));
+  }
+  for (GLuint loc = 0; loc < 5; ++loc) glVertexAttribDivisor(loc, 1);  // une balle par instance
+  glBindVertexArray(0);
+}
+
+void BallBatch::add(const glm::vec3& center, float radius, const glm::mat4& rotation) {
+  BallInstance b{{center.x, center.y, center.z}, radius, {}};
+  for (int c = 0; c < 3; ++c)
+    for (int r = 0; r < 3; ++r) b.rotation[c * 3 + r] = rotation[c][r];
+  balls_.push_back(b);
+}
+
+void BallBatch::upload() {
+  if (balls_.empty()) return;
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_.get());
+  if (balls_.size() > capacity_) {
+    capacity_ = std::max<std::size_t>(balls_.size(), capacity_ * 2);
+    glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(BallInstance), nullptr, GL_DYNAMIC_DRAW);
+    vbo_.remeasure();
+  }
+  glBufferSubData(GL_ARRAY_BUFFER, 0, balls_.size() * sizeof(BallInstance), balls_.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+} // namespace glx
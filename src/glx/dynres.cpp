@@ -0,0 +1,113 @@
+#include "glx/dynres.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace glx {
+
+static constexpr float SCALE_STEP = 1.0f / 16.0f;
+static constexpr int COOLDOWN_FRAMES = 10;
+static constexpr int CALM_FRAMES = 30;
+
+void OffscreenTarget::resize(int width, int height) {
+  if (width == w_ && height == h_ && fbo_) return;
+  w_ = width; h_ = height;
+
+  GLint prevTex = 0, prevFbo = 0;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTex);
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFbo);
+
+  auto makeTexture = [&](GLint internalFormat, GLenum format, GLenum type) {
+    GLuint t = 0;
+    glGenTextures(1, &t);
+    glBindTexture(GL_TEXTURE_2D, t);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, w_, h_, 0, format, type, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return t;
+  };
+  color_.reset(makeTexture(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE));
+  depth_.reset(makeTexture(GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT));
+
+  if (!fbo_) {
+    GLuint f = 0;
+    glGenFramebuffers(1, &f);
+    fbo_.reset(f);
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_.get());
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color_.get(), 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth_.get(), 0);
+  const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)prevFbo);
+  glBindTexture(GL_TEXTURE_2D, (GLuint)prevTex);
+  if (status != GL_FRAMEBUFFER_COMPLETE)
+    throw std::runtime_error("FBO hors écran incomplet");
+}
+
+void OffscreenTarget::bind() const {
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_.get());
+  glViewport(0, 0, w_, h_);
+}
+
+GpuTimer::GpuTimer() { glGenQueries(2, q_); }
+GpuTimer::~GpuTimer() { glDeleteQueries(2, q_); }
+
+void GpuTimer::begin() { glBeginQuery(GL_TIME_ELAPSED, q_[cur_]); }
+
+void GpuTimer::end() {
+  glEndQuery(GL_TIME_ELAPSED);
+  pending_[cur_] = true;
+  cur_ ^= 1;
+}
+
+bool GpuTimer::poll(double& ms) {
+  // Après end(), cur_ désigne la requête la plus ancienne (image précédente)
+  const int i = cur_;
+  if (!pending_[i]) return false;
+  GLint available = 0;
+  glGetQueryObjectiv(q_[i], GL_QUERY_RESULT_AVAILABLE, &available);
+  if (!available) return false;
+  GLuint64 ns = 0;
+  glGetQueryObjectui64v(q_[i], GL_QUERY_RESULT, &ns);
+  pending_[i] = false;
+  ms = ns * 1e-6;
+  return true;
+}
+
+ResolutionController::ResolutionController(double budgetMs, float minScale, float maxScale)
+  : budgetMs_(budgetMs), minScale_(minScale), maxScale_(maxScale), scale_(maxScale) {}
+
+void ResolutionController::setMaxScale(float s) {
+  maxScale_ = std::max(minScale_, s);
+  scale_ = std::min(scale_, maxScale_);
+}
+
+bool ResolutionController::update(double ms) {
+  avgMs_ = avgMs_ > 0.0 ? 0.8 * avgMs_ + 0.2 * ms : ms;
+  if (budgetMs_ <= 0.0) return false;
+  if (cooldown_ > 0) { --cooldown_; return false; }
+
+  const float prev = scale_;
+  if (avgMs_ > 1.1 * budgetMs_) {
+    // Coût ~ pixels ~ échelle² : on vise le budget en une fois
+    const float target = scale_ * (float)std::sqrt(budgetMs_ / avgMs_);
+    scale_ = std::max(minScale_, std::floor(target / SCALE_STEP) * SCALE_STEP);
+    calmFrames_ = 0;
+  } else if (avgMs_ < 0.7 * budgetMs_) {
+    if (++calmFrames_ >= CALM_FRAMES) {
+      scale_ = std::min(maxScale_, scale_ + SCALE_STEP);
+      calmFrames_ = 0;
+    }
+  } else {
+    calmFrames_ = 0;
+  }
+
+  if (scale_ == prev) return false;
+  cooldown_ = COOLDOWN_FRAMES;
+  return true;
+}
+
+} // namespace glx
@@ -0,0 +1,65 @@
+#include "glx/linebatch.hpp"
+#include <algorithm>
+#include <cstddef>
+
+namespace glx {
+
+LineBatch::LineBatch() {
+  GLuint vao = 0, vbo = 0;
+  glGenVertexArrays(1, &vao);
+  glGenBuffers(1, &vbo);
+  vao_.reset(vao);
+  vbo_.reset(vbo);
+
+  glBindVertexArray(vao);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  const GLsizei stride = sizeof(LineSegment);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(LineSegment, a));
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(LineSegment, b));
+  glEnableVertexAttribArray(2);
+  glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(LineSegment, color));
+  glEnableVertexAttribArray(3);
+  glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(LineSegment, thicknessPx));
+  for (GLuint loc = 0; loc < 4; ++loc) glVertexAttribDivisor(loc, 1);  // un segment par instance
+  glBindVertexArray(0);
+}
+
+void LineBatch::add(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color, float thicknessPx) {
+  segments_.push_back({{a.x, a.y, a.z}, {b.x, b.y, b.z}, {color.x, color.y, color.z}, thicknessPx});
+}
+
+void LineBatch::addPolyline(const std::vector<glm::vec3>& pts, bool closed, const glm::vec3& color,
+                            float thicknessPx) {
+  for (std::size_t i = 1; i < pts.size(); ++i) add(pts[i - 1], pts[i], color, thicknessPx);
+  if (closed && pts.size() > 2) add(pts.back(), pts.front(), color, thicknessPx);
+}
+
+void LineBatch::addPairs(const std::vector<glm::vec3>& pts, const glm::vec3& color, float thicknessPx) {
+  for (std::size_t i = 0; i + 1 < pts.size(); i += 2) add(pts[i], pts[i + 1], color, thicknessPx);
+}
+
+void LineBatch::markStatic() { staticCount_ = segments_.size(); }
+
+void LineBatch::clear() { segments_.resize(staticCount_); }
+
+void LineBatch::upload() {
+  if (segments_.empty()) return;
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_.get());
+  if (segments_.size() > capacity_) {
+    // Réallocation (x2) : tout est renvoyé
+    capacity_ = std::max<std::size_t>(segments_.size(), capacity_ * 2);
+    glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(LineSegment), nullptr, GL_DYNAMIC_DRAW);
+    vbo_.remeasure();
+    uploadedStatic_ = 0;
+  }
+  // Partie statique une seule fois, partie dynamique à chaque image
+  const std::size_t first = uploadedStatic_ == staticCount_ ? staticCount_ : 0;
+  glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(LineSegment),
+                  (segments_.size() - first) * sizeof(LineSegment), segments_.data() + first);
+  uploadedStatic_ = staticCount_;
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+} // namespace glx
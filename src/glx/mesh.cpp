@@ -3,6 +3,10 @@
 #include <array>        // OBLIGATOIRE pour std::array
 #include <glm/glm.hpp>  // OBLIGATOIRE pour glm::vec3
 #include <cmath> // Pour sqrt
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
 
 namespace glx {
 
@@ -41,6 +45,42 @@ Mesh createBackgroundQuad() {
   return m;
 }
 
+void setLitVertexLayout() {
+  const GLsizei stride = sizeof(LitVertex);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(LitVertex, px));
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(LitVertex, u));
+  glEnableVertexAttribArray(2);
+  glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(LitVertex, nx));
+}
+
+/**
+ * @brief Sol éclairable : deux triangles, UV [0,1], normale +Z.
+ */
+Mesh createFloorQuad(float hw, float hh) {
+  const LitVertex data[] = {
+    {-hw,-hh,0.f, 0.f,0.f, 0.f,0.f,1.f},
+    { hw,-hh,0.f, 1.f,0.f, 0.f,0.f,1.f},
+    { hw, hh,0.f, 1.f,1.f, 0.f,0.f,1.f},
+    {-hw,-hh,0.f, 0.f,0.f, 0.f,0.f,1.f},
+    { hw, hh,0.f, 1.f,1.f, 0.f,0.f,1.f},
+    {-hw, hh,0.f, 0.f,1.f, 0.f,0.f,1.f},
+  };
+
+  Mesh m; m.count = 6;
+  glGenVertexArrays(1, &m.vao);
+  glGenBuffers(1, &m.vbo);
+
+  glBindVertexArray(m.vao);
+  glBindBuffer(GL_ARRAY_BUFFER, m.vbo);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
+  setLitVertexLayout();
+
+  glBindVertexArray(0);
+  return m;
+}
+
 /**
  * @brief Cube en mode fil de fer, centré à l’origine.
  */
@@ -157,151 +197,44 @@ Mesh createWall(float x1, float y1, float x2, float y2, float height)
 }
 
 
-// ========================================================
-//  CRÉATION DE PLUSIEURS MURS EN UN SEUL MESH
-// ========================================================
-Mesh createWalls(const std::vector<std::array<float,4>>& segments,
-                 float height, float thickness)
-{
-    std::vector<float> vertices;
-    std::vector<GLuint> indices;
-    GLuint idx = 0; // Compteur pour les indices
-
-    float halfT = thickness / 2.0f;
-
-    for (const auto& s : segments)
-    {
-        float x1 = s[0], y1 = s[1];
-        float x2 = s[2], y2 = s[3];
-
-        // 1. Calcul du vecteur direction du mur
-        float dx = x2 - x1;
-        float dy = y2 - y1;
-        float len = std::sqrt(dx*dx + dy*dy);
-        
-        if (len < 0.001f) continue; // Sécurité si longueur nulle
-
-        // 2. Calcul du vecteur normal (perpendiculaire) unitaire
-        // Normal (-dy, dx) normalisé
-        float nx = -dy / len;
-        float ny =  dx / len;
-
-        // 3. Calcul du décalage pour l'épaisseur
-        float ox = nx * halfT;
-        float oy = ny * halfT;
-
-        // 4. Les 4 coins de la base du mur (au sol)
-        // A (x1 décalé gauche), B (x1 décalé droite)
-        // C (x2 décalé droite), D (x2 décalé gauche)
-        float Ax = x1 + ox, Ay = y1 + oy;
-        float Bx = x1 - ox, By = y1 - oy;
-        float Cx = x2 - ox, Cy = y2 - oy;
-        float Dx = x2 + ox, Dy = y2 + oy;
-
-        // --- Construction des sommets (Vertices) ---
-        // On va créer un cube : 8 sommets par mur (4 en bas, 4 en haut)
-        
-        // Z = 0 (Bas) -> Indices idx+0 à idx+3
-        float baseV[] = {
-            Ax, Ay, 0.0f,  // 0: A bas
-            Bx, By, 0.0f,  // 1: B bas
-            Cx, Cy, 0.0f,  // 2: C bas
-            Dx, Dy, 0.0f   // 3: D bas
-        };
-        vertices.insert(vertices.end(), baseV, baseV + 12);
-
-        // Z = height (Haut) -> Indices idx+4 à idx+7
-        float topV[] = {
-            Ax, Ay, height, // 4: A haut
-            Bx, By, height, // 5: B haut
-            Cx, Cy, height, // 6: C haut
-            Dx, Dy, height  // 7: D haut
-        };
-        vertices.insert(vertices.end(), topV, topV + 12);
-
-        // --- Construction des triangles (Indices) ---
-        // Il faut fermer la boîte (Côtés + Haut + Bas éventuellement)
-        
-        // Face 1 (Longer A->D) : 0,3,7,4
-        indices.push_back(idx+0); indices.push_back(idx+3); indices.push_back(idx+7);
-        indices.push_back(idx+0); indices.push_back(idx+7); indices.push_back(idx+4);
-
-        // Face 2 (Longer B->C) : 1,5,6,2
-        indices.push_back(idx+1); indices.push_back(idx+5); indices.push_back(idx+6);
-        indices.push_back(idx+1); indices.push_back(idx+6); indices.push_back(idx+2);
-
-        // Face 3 (Bout 1 A->B) : 0,4,5,1
-        indices.push_back(idx+0); indices.push_back(idx+4); indices.push_back(idx+5);
-        indices.push_back(idx+0); indices.push_back(idx+5); indices.push_back(idx+1);
-
-        // Face 4 (Bout 2 D->C) : 3,2,6,7
-        indices.push_back(idx+3); indices.push_back(idx+2); indices.push_back(idx+6);
-        indices.push_back(idx+3); indices.push_back(idx+6); indices.push_back(idx+7);
-
-        // Face 5 (Dessus - Le toit) : 4,7,6,5
-        indices.push_back(idx+4); indices.push_back(idx+7); indices.push_back(idx+6);
-        indices.push_back(idx+4); indices.push_back(idx+6); indices.push_back(idx+5);
-
-        // On passe au mur suivant (8 sommets ajoutés)
-        idx += 8;
-    }
-
-    Mesh m;
-    m.count = (GLsizei)indices.size();
-
-    glGenVertexArrays(1, &m.vao);
-    glGenBuffers(1, &m.vbo);
-    glGenBuffers(1, &m.ebo);
-
-    glBindVertexArray(m.vao);
-
-    glBindBuffer(GL_ARRAY_BUFFER, m.vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size()*sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m.ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size()*sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), (void*)0);
-
-    glBindVertexArray(0);
-    return m;
-}
-
+/**
+ * @brief Sphère UV au format LitVertex.
+ * Tampons remplis en place (tailles connues à l'avance).
+ */
 Mesh createSphere(float radius, int slices, int stacks) {
     Mesh m;
-    std::vector<float> vertices;
-    std::vector<GLuint> indices;
+    const int cols = slices + 1;
+    std::vector<LitVertex> vertices((std::size_t)(stacks + 1) * cols);
+    std::vector<GLuint> indices((std::size_t)stacks * slices * 6);
 
+    LitVertex* v = vertices.data();
     for (int i = 0; i <= stacks; ++i) {
         float V = i / (float)stacks;
         float phi = V * 3.14159265f;
+        const float sp = std::sin(phi), cp = std::cos(phi);
 
         for (int j = 0; j <= slices; ++j) {
             float U = j / (float)slices;
             float theta = U * 3.14159265f * 2.0f;
 
-            // Position x,y,z
-            float x = cos(theta) * sin(phi);
-            float y = cos(phi);
-            float z = sin(theta) * sin(phi);
-
-            // On ajoute: Position (3 floats) + Texture UV (2 floats)
-            vertices.push_back(x * radius);
-            vertices.push_back(y * radius);
-            vertices.push_back(z * radius);
-            vertices.push_back(1.0f - U); // 1-U pour inverser texture
-            vertices.push_back(V);
+            // Direction unitaire = normale
+            float x = std::cos(theta) * sp;
+            float y = cp;
+            float z = std::sin(theta) * sp;
+
+            // 1-U pour inverser texture
+            *v++ = {x * radius, y * radius, z * radius, 1.0f - U, V, x, y, z};
         }
     }
 
     // Indices (Triangles)
+    GLuint* e = indices.data();
     for (int i = 0; i < stacks; ++i) {
         for (int j = 0; j < slices; ++j) {
-            int p1 = i * (slices + 1) + j;
-            int p2 = p1 + (slices + 1);
-            indices.push_back(p1); indices.push_back(p2); indices.push_back(p1 + 1);
-            indices.push_back(p1 + 1); indices.push_back(p2); indices.push_back(p2 + 1);
+            GLuint p1 = i * cols + j;
+            GLuint p2 = p1 + cols;
+            *e++ = p1;     *e++ = p2; *e++ = p1 + 1;
+            *e++ = p1 + 1; *e++ = p2; *e++ = p2 + 1;
         }
     }
 
@@ -312,91 +245,179 @@ Mesh createSphere(float radius, int slices, int stacks) {
 
     glBindVertexArray(m.vao);
     glBindBuffer(GL_ARRAY_BUFFER, m.vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(LitVertex), vertices.data(), GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m.ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    setLitVertexLayout();
 
     glBindVertexArray(0);
     return m;
 }
 
 // ========================================================
-//  CRÉATION DE PLUSIEURS MURS EN UN SEUL MESH
+//  MURS : MAILLAGE UNIQUE (faces, normales, UV ; arêtes côté CPU)
 // ========================================================
-Mesh createWallsWireframe(const std::vector<std::array<float,4>>& segments,
-                          float height, float thickness)
+namespace {
+
+struct WallFootprint {
+  glm::vec2 a, b, dir, n;
+  float len;
+};
+
+// p est-il dans l'emprise (rectangle épaissi) du mur w ?
+bool insideFootprint(const WallFootprint& w, glm::vec2 p, float halfT, float eps) {
+  const glm::vec2 d = p - w.a;
+  const float t = glm::dot(d, w.dir), s = glm::dot(d, w.n);
+  return t >= -eps && t <= w.len + eps && std::abs(s) <= halfT + eps;
+}
+
+// Grille spatiale uniforme sur les boîtes englobantes des murs
+struct WallGrid {
+  float cell;
+  std::unordered_map<std::int64_t, std::vector<int>> cells;
+
+  static std::int64_t key(int ix, int iy) {
+    return ((std::int64_t)ix << 32) ^ (std::int64_t)(std::uint32_t)iy;
+  }
+  int coord(float v) const { return (int)std::floor(v / cell); }
+
+  void insert(int id, glm::vec2 lo, glm::vec2 hi) {
+    for (int iy = coord(lo.y); iy <= coord(hi.y); ++iy)
+      for (int ix = coord(lo.x); ix <= coord(hi.x); ++ix)
+        cells[key(ix, iy)].push_back(id);
+  }
+  const std::vector<int>* at(glm::vec2 p) const {
+    auto it = cells.find(key(coord(p.x), coord(p.y)));
+    return it == cells.end() ? nullptr : &it->second;
+  }
+};
+
+} // namespace
+
+WallMesh createWallMesh(const std::vector<std::array<float,4>>& segments,
+                        float height, float thickness, float mergeEps)
 {
-    std::vector<float> vertices;
-    std::vector<GLuint> indices;
-    GLuint idx = 0; 
-
-    float halfT = thickness / 2.0f;
-
-    for (const auto& s : segments)
-    {
-        float x1 = s[0], y1 = s[1];
-        float x2 = s[2], y2 = s[3];
-        float dx = x2 - x1;
-        float dy = y2 - y1;
-        float len = std::sqrt(dx*dx + dy*dy);
-        if (len < 0.001f) continue;
-        float nx = -dy / len;
-        float ny =  dx / len;
-        float ox = nx * halfT;
-        float oy = ny * halfT;
-        float Ax = x1 + ox, Ay = y1 + oy;
-        float Bx = x1 - ox, By = y1 - oy;
-        float Cx = x2 - ox, Cy = y2 - oy;
-        float Dx = x2 + ox, Dy = y2 + oy;
-
-        // --- Sommets (identique à createWalls) ---
-        float baseV[] = { Ax, Ay, 0.0f,  Bx, By, 0.0f,  Cx, Cy, 0.0f,  Dx, Dy, 0.0f };
-        vertices.insert(vertices.end(), baseV, baseV + 12);
-        float topV[] = { Ax, Ay, height, Bx, By, height, Cx, Cy, height, Dx, Dy, height };
-        vertices.insert(vertices.end(), topV, topV + 12);
-
-
-        // 1. Le rectangle du BAS (4 lignes)
-        indices.push_back(idx+0); indices.push_back(idx+1); // A->B
-        indices.push_back(idx+1); indices.push_back(idx+2); // B->C
-        indices.push_back(idx+2); indices.push_back(idx+3); // C->D
-        indices.push_back(idx+3); indices.push_back(idx+0); // D->A
-
-        // 2. Le rectangle du HAUT (4 lignes)
-        indices.push_back(idx+4); indices.push_back(idx+5); // A'->B'
-        indices.push_back(idx+5); indices.push_back(idx+6); // B'->C'
-        indices.push_back(idx+6); indices.push_back(idx+7); // C'->D'
-        indices.push_back(idx+7); indices.push_back(idx+4); // D'->A'
-
-        // 3. Les 4 Piliers VERTICAUX
-        indices.push_back(idx+0); indices.push_back(idx+4); // A->A'
-        indices.push_back(idx+1); indices.push_back(idx+5); // B->B'
-        indices.push_back(idx+2); indices.push_back(idx+6); // C->C'
-        indices.push_back(idx+3); indices.push_back(idx+7); // D->D'
-
-        idx += 8;
+    const float halfT = thickness / 2.0f;
+
+    // 1. Emprises au sol (segments dégénérés ignorés)
+    std::vector<WallFootprint> walls;
+    walls.reserve(segments.size());
+    float totalLen = 0.f;
+    for (const auto& s : segments) {
+        WallFootprint w;
+        w.a = {s[0], s[1]};
+        w.b = {s[2], s[3]};
+        w.len = glm::length(w.b - w.a);
+        if (w.len < 0.001f) continue;
+        w.dir = (w.b - w.a) / w.len;
+        w.n = {-w.dir.y, w.dir.x};
+        walls.push_back(w);
+        totalLen += w.len;
     }
 
-    Mesh m;
-    m.count = (GLsizei)indices.size();
+    // 2. Grille : taille de case ~ longueur moyenne d'un mur
+    WallGrid grid;
+    grid.cell = std::max(thickness, walls.empty() ? 1.f : totalLen / walls.size());
+    const glm::vec2 margin(halfT + mergeEps);
+    for (int i = 0; i < (int)walls.size(); ++i) {
+        const glm::vec2 a = walls[i].a, b = walls[i].b;
+        grid.insert(i, glm::vec2(std::min(a.x, b.x), std::min(a.y, b.y)) - margin,
+                       glm::vec2(std::max(a.x, b.x), std::max(a.y, b.y)) + margin);
+    }
+
+    // Bout caché : ses deux coins sont dans l'emprise d'un même autre mur
+    auto capHidden = [&](int self, glm::vec2 c0, glm::vec2 c1) {
+        const std::vector<int>* cand = grid.at(c0);
+        if (!cand) return false;
+        for (int j : *cand)
+            if (j != self && insideFootprint(walls[j], c0, halfT, mergeEps)
+                          && insideFootprint(walls[j], c1, halfT, mergeEps))
+                return true;
+        return false;
+    };
+
+    // 3. Sommets et indices
+    std::vector<LitVertex> vertices;
+    std::vector<std::uint32_t> tris, edges;
+    vertices.reserve(walls.size() * 20);
+    tris.reserve(walls.size() * 30);
+    edges.reserve(walls.size() * 24);
+
+    // Ajoute un quad (4 sommets) ; l'ordre des triangles suit la normale sortante
+    auto addQuad = [&](const glm::vec3 (&p)[4], const glm::vec2 (&uv)[4], glm::vec3 n) {
+        const std::uint32_t base = (std::uint32_t)vertices.size();
+        for (int k = 0; k < 4; ++k)
+            vertices.push_back({p[k].x, p[k].y, p[k].z, uv[k].x, uv[k].y, n.x, n.y, n.z});
+        const bool ccw = glm::dot(glm::cross(p[1] - p[0], p[2] - p[0]), n) >= 0.f;
+        const std::uint32_t order[6] = {0,1,2, 0,2,3};
+        for (int k = 0; k < 6; ++k)
+            tris.push_back(base + (ccw ? order[k] : order[5 - k]));
+        return base;
+    };
+
+    for (int i = 0; i < (int)walls.size(); ++i) {
+        const WallFootprint& w = walls[i];
+        const glm::vec2 o = w.n * halfT;
+        // A (début, +n), B (début, -n), C (fin, -n), D (fin, +n)
+        const glm::vec2 A = w.a + o, B = w.a - o, C = w.b - o, D = w.b + o;
+        auto at = [](glm::vec2 q, float z) { return glm::vec3(q, z); };
+        const float L = w.len / height, T = thickness / height, Hh = 1.f;
+        const glm::vec3 n3(w.n, 0.f), d3(w.dir, 0.f), up(0.f, 0.f, 1.f);
+
+        const std::uint32_t sp = addQuad({at(A,0), at(D,0), at(D,height), at(A,height)},
+                                         {{0,0}, {L,0}, {L,Hh}, {0,Hh}}, n3);
+        const std::uint32_t sm = addQuad({at(B,0), at(C,0), at(C,height), at(B,height)},
+                                         {{0,0}, {L,0}, {L,Hh}, {0,Hh}}, -n3);
+        addQuad({at(A,height), at(D,height), at(C,height), at(B,height)},
+                {{0,0}, {L,0}, {L,T}, {0,T}}, up);
+        if (!capHidden(i, A, B))
+            addQuad({at(A,0), at(B,0), at(B,height), at(A,height)}, {{0,0}, {T,0}, {T,Hh}, {0,Hh}}, -d3);
+        if (!capHidden(i, D, C))
+            addQuad({at(D,0), at(C,0), at(C,height), at(D,height)}, {{0,0}, {T,0}, {T,Hh}, {0,Hh}}, d3);
+
+        // Contours de la boîte (bas, haut, piliers) sur les sommets des faces latérales
+        const std::uint32_t A0 = sp+0, D0 = sp+1, D1 = sp+2, A1 = sp+3;
+        const std::uint32_t B0 = sm+0, C0 = sm+1, C1 = sm+2, B1 = sm+3;
+        const std::uint32_t E[24] = {
+            A0,B0, B0,C0, C0,D0, D0,A0,   // bas
+            A1,B1, B1,C1, C1,D1, D1,A1,   // haut
+            A0,A1, B0,B1, C0,C1, D0,D1    // piliers
+        };
+        edges.insert(edges.end(), E, E + 24);
+    }
+
+    // 4. Upload : un VBO, un EBO de triangles, indices 16 bits si possible
+    WallMesh wm;
+    wm.vertexCount = (GLsizei)vertices.size();
+    const bool small = vertices.size() <= 0xFFFF;
+    wm.indexType = small ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    const std::size_t isz = small ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+
+    std::vector<std::uint8_t> ebo(tris.size() * isz);
+    for (std::size_t k = 0; k < tris.size(); ++k) {
+        if (small) reinterpret_cast<std::uint16_t*>(ebo.data())[k] = (std::uint16_t)tris[k];
+        else       reinterpret_cast<std::uint32_t*>(ebo.data())[k] = tris[k];
+    }
+    wm.edgePoints.reserve(edges.size());
+    for (std::uint32_t k : edges)
+        wm.edgePoints.emplace_back(vertices[k].px, vertices[k].py, vertices[k].pz);
+    wm.triangles = {(GLsizei)tris.size(), 0};
+
+    Mesh& m = wm.mesh;
+    m.count = (GLsizei)tris.size();
     glGenVertexArrays(1, &m.vao);
     glGenBuffers(1, &m.vbo);
     glGenBuffers(1, &m.ebo);
 
     glBindVertexArray(m.vao);
     glBindBuffer(GL_ARRAY_BUFFER, m.vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size()*sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(LitVertex), vertices.data(), GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m.ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size()*sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), (void*)0);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, ebo.size(), ebo.data(), GL_STATIC_DRAW);
+
+    setLitVertexLayout();
+
     glBindVertexArray(0);
-    return m;
+    return wm;
 }
 } // namespace glx
@@ -0,0 +1,46 @@
+#include "glx/meshcache.hpp"
+#include <cmath>
+
+namespace glx {
+
+const Mesh& MeshCache::get(const std::string& shape, const Params& params,
+                           const std::function<Mesh()>& build) {
+  auto key = std::make_pair(shape, params);
+  auto it = meshes_.find(key);
+  if (it == meshes_.end()) it = meshes_.emplace(std::move(key), MeshHandle(build())).first;
+  return it->second.get();
+}
+
+const Mesh& MeshCache::sphere(float radius, int slices, int stacks) {
+  return get("sphere", {radius, (float)slices, (float)stacks, 0.f},
+             [=] { return createSphere(radius, slices, stacks); });
+}
+
+void MeshCache::clear() {
+  meshes_.clear();
+}
+
+/**
+ * @brief Niveau le plus grossier dont l'arête équatoriale projetée
+ * (2*pi*r_px / tranches) reste sous maxEdgePx.
+ */
+int SphereLOD::select(float distance, float focalPx, float maxEdgePx) const {
+  if (distance <= radius) return LEVELS - 1;   // caméra dans / contre la balle
+  const float rPx = radius * focalPx / distance;
+  const float circumPx = 2.f * 3.14159265f * rPx;
+  for (int l = 0; l < LEVELS; ++l)
+    if (circumPx / SLICES[l] <= maxEdgePx) return l;
+  return LEVELS - 1;
+}
+
+SphereLOD createSphereLOD(MeshCache& cache, float radius) {
+  SphereLOD lod;
+  lod.radius = radius;
+  for (int l = 0; l < SphereLOD::LEVELS; ++l) {
+    const int slices = SphereLOD::SLICES[l];
+    lod.levels[l] = &cache.sphere(radius, slices, slices);  // stacks = slices (comme 32x32)
+  }
+  return lod;
+}
+
+} // namespace glx
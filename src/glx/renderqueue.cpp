@@ -0,0 +1,122 @@
+#include "glx/renderqueue.hpp"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace glx {
+
+static DrawItem& push(DrawItem& d, GLint loc, UniformValue::Type type, const float* v, int n) {
+  if (loc < 0 || d.uniformCount >= DrawItem::MAX_UNIFORMS) return d;  // uniform absent du programme
+  UniformValue& u = d.uniforms[d.uniformCount++];
+  u.location = loc;
+  u.type = type;
+  std::memcpy(u.v, v, n * sizeof(float));
+  return d;
+}
+
+DrawItem& DrawItem::set(GLint loc, int v) {
+  float f; std::memcpy(&f, &v, sizeof f);   // stocké bit à bit
+  return push(*this, loc, UniformValue::Int, &f, 1);
+}
+DrawItem& DrawItem::set(GLint loc, float v)            { return push(*this, loc, UniformValue::Float, &v, 1); }
+DrawItem& DrawItem::set(GLint loc, const glm::vec2& v) { return push(*this, loc, UniformValue::Vec2, glm::value_ptr(v), 2); }
+DrawItem& DrawItem::set(GLint loc, const glm::vec3& v) { return push(*this, loc, UniformValue::Vec3, glm::value_ptr(v), 3); }
+DrawItem& DrawItem::set(GLint loc, const glm::vec4& v) { return push(*this, loc, UniformValue::Vec4, glm::value_ptr(v), 4); }
+DrawItem& DrawItem::set(GLint loc, const glm::mat3& m) { return push(*this, loc, UniformValue::Mat3, glm::value_ptr(m), 9); }
+DrawItem& DrawItem::set(GLint loc, const glm::mat4& m) { return push(*this, loc, UniformValue::Mat4, glm::value_ptr(m), 16); }
+
+DrawItem& RenderQueue::drawArrays(Layer layer, GLuint program, GLuint vao, GLenum mode, GLsizei count) {
+  items_.emplace_back();
+  DrawItem& d = items_.back();
+  d.layer = layer; d.program = program; d.vao = vao; d.mode = mode; d.count = count;
+  if (layer == Layer::Background) d.state.depthTest = false;
+  if (layer == Layer::Transparent) d.state.blend = true;
+  return d;
+}
+
+DrawItem& RenderQueue::drawElements(Layer layer, GLuint program, GLuint vao, GLenum mode, GLsizei count,
+                                    GLenum indexType, GLintptr offset) {
+  DrawItem& d = drawArrays(layer, program, vao, mode, count);
+  d.indexType = indexType;
+  d.indexOffset = offset;
+  return d;
+}
+
+static void applyUniform(const UniformValue& u) {
+  switch (u.type) {
+    case UniformValue::Int:   { int i; std::memcpy(&i, u.v, sizeof i); glUniform1i(u.location, i); break; }
+    case UniformValue::Float: glUniform1f(u.location, u.v[0]); break;
+    case UniformValue::Vec2:  glUniform2fv(u.location, 1, u.v); break;
+    case UniformValue::Vec3:  glUniform3fv(u.location, 1, u.v); break;
+    case UniformValue::Vec4:  glUniform4fv(u.location, 1, u.v); break;
+    case UniformValue::Mat3:  glUniformMatrix3fv(u.location, 1, GL_FALSE, u.v); break;
+    case UniformValue::Mat4:  glUniformMatrix4fv(u.location, 1, GL_FALSE, u.v); break;
+  }
+}
+
+static void setCap(GLenum cap, bool on) { if (on) glEnable(cap); else glDisable(cap); }
+
+/**
+ * @brief Clé de tri 64 bits : couche | états | programme | texture | VAO
+ * (ordre de soumission pour la couche transparente).
+ */
+void RenderQueue::execute(Layer from, Layer to) {
+  order_.clear();
+  order_.reserve(items_.size());
+  for (std::uint32_t i = 0; i < items_.size(); ++i) {
+    const DrawItem& d = items_[i];
+    if (d.layer < from || d.layer > to) continue;
+    std::uint64_t key = (std::uint64_t)d.layer << 60;
+    if (d.layer == Layer::Transparent) {
+      key |= i;
+    } else {
+      key |= (std::uint64_t)d.state.bits() << 56;
+      key |= (std::uint64_t)(d.program & 0xFFFF) << 40;
+      key |= (std::uint64_t)(d.texture & 0xFFFF) << 24;
+      key |= (std::uint64_t)(d.vao & 0xFFFF) << 8;
+    }
+    order_.push_back({key, i});
+  }
+  std::stable_sort(order_.begin(), order_.end(),
+                   [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+  stats_ = Stats{};
+  GLuint curProgram = 0, curVao = 0, curTex = 0;
+  int curState = -1;   // inconnu : premier draw => tout est posé
+  glActiveTexture(GL_TEXTURE0);
+  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  glPolygonOffset(1.0f, 1.0f);
+
+  for (const Entry& e : order_) {
+    const DrawItem& d = items_[e.index];
+
+    const int bits = d.state.bits();
+    if (bits != curState) {
+      setCap(GL_DEPTH_TEST, d.state.depthTest);
+      setCap(GL_BLEND, d.state.blend);
+      setCap(GL_POLYGON_OFFSET_FILL, d.state.polygonOffset);
+      curState = bits;
+      ++stats_.stateChanges;
+    }
+    if (d.program != curProgram) { glUseProgram(d.program); curProgram = d.program; ++stats_.programBinds; }
+    if (d.texture && d.texture != curTex) { glBindTexture(GL_TEXTURE_2D, d.texture); curTex = d.texture; ++stats_.textureBinds; }
+    if (d.vao != curVao) { glBindVertexArray(d.vao); curVao = d.vao; ++stats_.vaoBinds; }
+
+    for (int u = 0; u < d.uniformCount; ++u) applyUniform(d.uniforms[u]);
+
+    if (d.instances) {
+      if (d.indexType) glDrawElementsInstanced(d.mode, d.count, d.indexType, (void*)d.indexOffset, d.instances);
+      else             glDrawArraysInstanced(d.mode, 0, d.count, d.instances);
+    } else {
+      if (d.indexType) glDrawElements(d.mode, d.count, d.indexType, (void*)d.indexOffset);
+      else             glDrawArrays(d.mode, 0, d.count);
+    }
+    ++stats_.draws;
+  }
+
+  glBindVertexArray(0);
+  setCap(GL_BLEND, false);
+  setCap(GL_POLYGON_OFFSET_FILL, false);
+}
+
+} // namespace glx
@@ -0,0 +1,98 @@
+#include "glx/resource.hpp"
+#include <ostream>
+
+namespace glx {
+
+ResourceRegistry& ResourceRegistry::instance() {
+  static ResourceRegistry r;
+  return r;
+}
+
+void ResourceRegistry::add(GpuKind kind, GLuint id, std::size_t bytes) {
+  std::lock_guard<std::mutex> lk(m_);
+  live_[{(int)kind, id}] = bytes;
+}
+
+void ResourceRegistry::update(GpuKind kind, GLuint id, std::size_t bytes) {
+  add(kind, id, bytes);
+}
+
+void ResourceRegistry::remove(GpuKind kind, GLuint id) {
+  std::lock_guard<std::mutex> lk(m_);
+  live_.erase({(int)kind, id});
+}
+
+GpuStats ResourceRegistry::stats() const {
+  std::lock_guard<std::mutex> lk(m_);
+  GpuStats s;
+  for (const auto& kv : live_) {
+    const int kind = kv.first.first;
+    ++s.count[kind];
+    if (kind == (int)GpuKind::Buffer)  s.bufferBytes += kv.second;
+    if (kind == (int)GpuKind::Texture) s.textureBytes += kv.second;
+  }
+  return s;
+}
+
+void ResourceRegistry::report(std::ostream& os) const {
+  const GpuStats s = stats();
+  os << "[GPU] " << s.count[(int)GpuKind::Buffer] << " tampons ("
+     << s.bufferBytes / 1024 << " Kio), "
+     << s.count[(int)GpuKind::Texture] << " textures (~"
+     << s.textureBytes / 1024 << " Kio), "
+     << s.count[(int)GpuKind::VertexArray] << " VAO, "
+     << s.count[(int)GpuKind::Program] << " programmes, "
+     << s.count[(int)GpuKind::Framebuffer] << " FBO\n";
+}
+
+// Octets par texel (format interne) ; les formats RGB sont stockés sur 4 octets par les drivers
+static std::size_t texelBytes(GLint internalFormat) {
+  switch (internalFormat) {
+    case GL_R8: case GL_RED: return 1;
+    case GL_RG8: case GL_RG: return 2;
+    case GL_DEPTH_COMPONENT24: case GL_DEPTH24_STENCIL8: return 4;
+    case GL_RGBA16F: return 8;
+    default: return 4;
+  }
+}
+
+/**
+ * @brief Interroge le driver en préservant les liaisons courantes.
+ */
+std::size_t measureGpuObject(GpuKind kind, GLuint id) {
+  if (kind == GpuKind::Buffer) {
+    GLint prev = 0, size = 0;
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &prev);
+    glBindBuffer(GL_ARRAY_BUFFER, id);
+    glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+    glBindBuffer(GL_ARRAY_BUFFER, (GLuint)prev);
+    return (std::size_t)size;
+  }
+  if (kind == GpuKind::Texture) {
+    GLint prev = 0, w = 0, h = 0, fmt = 0, minFilter = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &prev);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &fmt);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &minFilter);
+    glBindTexture(GL_TEXTURE_2D, (GLuint)prev);
+    std::size_t bytes = (std::size_t)w * h * texelBytes(fmt);
+    if (minFilter != GL_LINEAR && minFilter != GL_NEAREST) bytes = bytes * 4 / 3;  // chaîne de mipmaps
+    return bytes;
+  }
+  return 0;
+}
+
+void destroyGpuObject(GpuKind kind, GLuint id) {
+  switch (kind) {
+    case GpuKind::Buffer:      glDeleteBuffers(1, &id); break;
+    case GpuKind::VertexArray: glDeleteVertexArrays(1, &id); break;
+    case GpuKind::Texture:     glDeleteTextures(1, &id); break;
+    case GpuKind::Program:     glDeleteProgram(id); break;
+    case GpuKind::Framebuffer: glDeleteFramebuffers(1, &id); break;
+    default: break;
+  }
+}
+
+} // namespace glx
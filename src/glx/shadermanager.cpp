@@ -0,0 +1,196 @@
+#include "glx/shadermanager.hpp"
+#include "glx/shaders.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace glx {
+
+namespace {
+
+constexpr char BINARY_MAGIC[8] = {'A','R','G','L','B','I','N','1'};
+
+/// En-tête d'un binaire de programme en cache.
+struct BinaryHeader {
+  char magic[8];
+  std::uint32_t format;    //!< GLenum renvoyé par glGetProgramBinary
+  std::uint32_t length;    //!< Taille du binaire (octets)
+  std::uint64_t key;       //!< Clé complète (les noms de fichiers peuvent collisionner)
+  std::uint64_t checksum;  //!< FNV-1a du binaire
+};
+
+// FNV-1a 64 bits
+std::uint64_t fnv1a(const void* data, std::size_t n, std::uint64_t h = 1469598103934665603ull) {
+  const auto* p = static_cast<const std::uint8_t*>(data);
+  for (std::size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+  return h;
+}
+
+/// Insère les #define des variantes juste après la ligne #version.
+std::string withDefines(const char* src, unsigned variants) {
+  static const struct { unsigned bit; const char* name; } NAMES[] = {
+    {VARIANT_TEXTURED, "TEXTURED"}, {VARIANT_LIT, "LIT"},
+    {VARIANT_INSTANCED, "INSTANCED"}, {VARIANT_VERTEX_COLOR, "VERTEX_COLOR"},
+  };
+  std::string s(src);
+  if (!variants) return s;
+  std::string defines;
+  for (const auto& n : NAMES)
+    if (variants & n.bit) defines += std::string("#define ") + n.name + "\n";
+  const std::size_t eol = s.find('\n');
+  if (s.compare(0, 8, "#version") == 0 && eol != std::string::npos) s.insert(eol + 1, defines);
+  else s.insert(0, defines);
+  return s;
+}
+
+void mkdirs(const std::string& path) {
+  for (std::size_t i = 1; i <= path.size(); ++i)
+    if (i == path.size() || path[i] == '/') ::mkdir(path.substr(0, i).c_str(), 0755);
+}
+
+std::string hex(std::uint64_t v) {
+  char buf[17];
+  std::snprintf(buf, sizeof buf, "%016llx", (unsigned long long)v);
+  return buf;
+}
+
+const char* glString(GLenum name) {
+  const GLubyte* s = glGetString(name);
+  return s ? reinterpret_cast<const char*>(s) : "";
+}
+
+bool linked(GLuint p) {
+  GLint ok = GL_FALSE;
+  glGetProgramiv(p, GL_LINK_STATUS, &ok);
+  return ok == GL_TRUE;
+}
+
+/// Relit un binaire ; 0 s'il est absent, corrompu ou refusé par le driver.
+GLuint loadBinary(const std::string& path, std::uint64_t key) {
+  std::ifstream f(path, std::ios::binary | std::ios::ate);
+  if (!f) return 0;
+  const std::streamoff fileBytes = f.tellg();
+  f.seekg(0);
+  BinaryHeader h{};
+  if (!f.read(reinterpret_cast<char*>(&h), sizeof h) ||
+      std::memcmp(h.magic, BINARY_MAGIC, 8) != 0 || h.key != key)
+    return 0;
+  // Longueur annoncée = reste du fichier (en-tête corrompu ou fichier tronqué : pas d'allocation)
+  if (fileBytes < (std::streamoff)sizeof h || (std::uint64_t)h.length != (std::uint64_t)(fileBytes - sizeof h))
+    return 0;
+  std::vector<char> bin(h.length);
+  if (!f.read(bin.data(), (std::streamsize)bin.size()) || fnv1a(bin.data(), bin.size()) != h.checksum)
+    return 0;
+
+  GLuint p = glCreateProgram();
+  glProgramBinary(p, h.format, bin.data(), (GLsizei)bin.size());
+  if (!linked(p)) { glDeleteProgram(p); return 0; }  // driver mis à jour, binaire refusé
+  return p;
+}
+
+/// Écrit le binaire dans un fichier temporaire renommé ensuite.
+void storeBinary(const std::string& path, std::uint64_t key, GLuint p) {
+  GLint len = 0;
+  glGetProgramiv(p, GL_PROGRAM_BINARY_LENGTH, &len);
+  if (len <= 0) return;
+  std::vector<char> bin(len);
+  GLenum format = 0;
+  GLsizei got = 0;
+  glGetProgramBinary(p, len, &got, &format, bin.data());
+  if (got <= 0) return;
+  bin.resize(got);
+
+  BinaryHeader h{};
+  std::memcpy(h.magic, BINARY_MAGIC, 8);
+  h.format = format;
+  h.length = (std::uint32_t)bin.size();
+  h.key = key;
+  h.checksum = fnv1a(bin.data(), bin.size());
+
+  const std::string tmp = path + ".tmp" + std::to_string((long)getpid());
+  std::ofstream f(tmp, std::ios::binary);
+  if (!f || !f.write(reinterpret_cast<const char*>(&h), sizeof h) ||
+      !f.write(bin.data(), (std::streamsize)bin.size())) {
+    std::remove(tmp.c_str());
+    return;
+  }
+  f.close();
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) std::remove(tmp.c_str());
+}
+
+} // namespace
+
+std::string defaultShaderCacheDir() {
+  if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) return std::string(xdg) + "/ar-a4/shaders";
+  if (const char* home = std::getenv("HOME"); home && *home) return std::string(home) + "/.cache/ar-a4/shaders";
+  return {};
+}
+
+ShaderManager::ShaderManager(std::string cacheDir) : cacheDir_(std::move(cacheDir)) {
+  driver_ = std::string(glString(GL_VENDOR)) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+  GLint formats = 0;
+  if (GLEW_ARB_get_program_binary) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  binarySupported_ = formats > 0;
+  if (binarySupported_ && !cacheDir_.empty()) mkdirs(cacheDir_);
+}
+
+GLuint ShaderManager::build(const ProgramSource& src, unsigned variants) {
+  const auto t0 = std::chrono::steady_clock::now();
+  struct Stage { GLenum type; std::string text; };
+  std::vector<Stage> stages;
+  stages.push_back({GL_VERTEX_SHADER, withDefines(src.vs, variants)});
+  if (src.gs) stages.push_back({GL_GEOMETRY_SHADER, withDefines(src.gs, variants)});
+  stages.push_back({GL_FRAGMENT_SHADER, withDefines(src.fs, variants)});
+
+  // Clé : driver + sources après injection (séparées par leur type d'étage)
+  std::uint64_t key = fnv1a(driver_.data(), driver_.size());
+  for (const Stage& s : stages) {
+    key = fnv1a(&s.type, sizeof s.type, key);
+    key = fnv1a(s.text.data(), s.text.size(), key);
+  }
+  const bool useCache = binarySupported_ && !cacheDir_.empty();
+  const std::string path = useCache ? cacheDir_ + "/" + hex(key) + ".glbin" : std::string();
+
+  GLuint p = useCache ? loadBinary(path, key) : 0;
+  if (p) {
+    ++stats_.cacheHits;
+  } else {
+    std::vector<GLuint> shaders;
+    try {
+      for (const Stage& s : stages) shaders.push_back(compile(s.type, s.text.c_str()));
+    } catch (...) {
+      for (GLuint s : shaders) glDeleteShader(s);
+      throw;
+    }
+    p = glCreateProgram();
+    for (GLuint s : shaders) glAttachShader(p, s);
+    if (useCache) glProgramParameteri(p, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(p);
+    for (GLuint s : shaders) { glDetachShader(p, s); glDeleteShader(s); }
+    if (!linked(p)) {
+      GLint logLen = 0;
+      glGetProgramiv(p, GL_INFO_LOG_LENGTH, &logLen);
+      std::vector<GLchar> log(std::max(1, logLen));
+      glGetProgramInfoLog(p, logLen, nullptr, log.data());
+      std::cerr << "Program link error: " << log.data() << std::endl;
+      glDeleteProgram(p);
+      throw std::runtime_error("Program link failed");
+    }
+    ++stats_.compiled;
+    if (useCache) storeBinary(path, key, p);
+  }
+  stats_.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  return p;
+}
+
+} // namespace glx
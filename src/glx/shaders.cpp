@@ -86,7 +86,18 @@ void main() {
 const char* const LINE_VS = R"(#version 330 core
 layout (location = 0) in vec3 aPos;
 uniform mat4 uMVP;
+out vec3 vColor;
+#ifdef VERTEX_COLOR
+layout (location = 1) in vec3 aColor;   // plusieurs segments colorés en un seul draw
+#else
+uniform vec3 uColor;
+#endif
 void main() {
+#ifdef VERTEX_COLOR
+  vColor = aColor;
+#else
+  vColor = uColor;
+#endif
   gl_Position = uMVP * vec4(aPos, 1.0);
 })";
 
@@ -95,6 +106,8 @@ layout(lines) in;
 layout(triangle_strip, max_vertices = 4) out;
 uniform float uThicknessPx;
 uniform vec2 uViewport;
+in vec3 vColor[];
+out vec3 gColor;
 
 void main() {
   vec4 p0 = gl_in[0].gl_Position;
@@ -123,140 +136,270 @@ void main() {
   vec4 v2 = vec4(ndc1 - off, z1, 1.0);
   vec4 v3 = vec4(ndc1 + off, z1, 1.0);
 
-  gl_Position = v0; EmitVertex();
-  gl_Position = v1; EmitVertex();
-  gl_Position = v2; EmitVertex();
-  gl_Position = v3; EmitVertex();
+  gColor = vColor[0]; gl_Position = v0; EmitVertex();
+  gColor = vColor[0]; gl_Position = v1; EmitVertex();
+  gColor = vColor[1]; gl_Position = v2; EmitVertex();
+  gColor = vColor[1]; gl_Position = v3; EmitVertex();
   EndPrimitive();
 })";
 
 const char* const LINE_FS = R"(#version 330 core
+in vec3 gColor;
 out vec4 FragColor;
-uniform vec3 uColor;
 void main() {
-  FragColor = vec4(uColor, 1.0);
+  FragColor = vec4(gColor, 1.0);
 })";
 
-const char* const SOLID_VS = R"(#version 330 core
-layout (location = 0) in vec3 aPos;
+// --- Lignes épaisses sans geometry shader : un segment par instance ---
+// Quad de 4 sommets (GL_TRIANGLE_STRIP) construit à partir de gl_VertexID ;
+// même convention d'épaisseur que LINE_GS, fragment shader LINE_FS.
+const char* const LINE_INST_VS = R"(#version 330 core
+layout (location = 0) in vec3 aP0;
+layout (location = 1) in vec3 aP1;
+layout (location = 2) in vec3 aColor;
+layout (location = 3) in float aThicknessPx;
 uniform mat4 uMVP;
-void main() {
-    gl_Position = uMVP * vec4(aPos, 1.0);
-}
-)";
+uniform vec2 uViewport;
+out vec3 gColor;
 
-const char* const SOLID_FS = R"(#version 330 core
-out vec4 FragColor;
-uniform vec3 uColor;
 void main() {
-    FragColor = vec4(uColor, 1.0);
-}
-)";
-const char* const TEX_OBJ_VS = R"(#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aUV;
-uniform mat4 uMVP;
-out vec2 vUV;
-void main() {
-    gl_Position = uMVP * vec4(aPos, 1.0);
-    vUV = aUV; 
-})";
+  vec4 c0 = uMVP * vec4(aP0, 1.0);
+  vec4 c1 = uMVP * vec4(aP1, 1.0);
 
-const char* const TEX_OBJ_FS = R"(#version 330 core
-in vec2 vUV;
-out vec4 FragColor;
-uniform sampler2D uTex;
-void main() {
-    FragColor = texture(uTex, vUV);
+  // direction et normale à l'écran (en pixels)
+  vec2 dir = (c1.xy / c1.w - c0.xy / c0.w) * uViewport;
+  float len = length(dir);
+  vec2 n = (len > 1e-6) ? vec2(-dir.y, dir.x) / len : vec2(0.0, 1.0);
+
+  // sommets 0,1 : extrémité 0 ; 2,3 : extrémité 1 ; parité : côté de la ligne
+  vec4 c = (gl_VertexID < 2) ? c0 : c1;
+  float side = ((gl_VertexID & 1) == 0) ? -1.0 : 1.0;
+
+  // décalage px -> NDC, ramené en espace clip (multiplié par w)
+  vec2 off = n * (side * aThicknessPx) * (2.0 / uViewport);
+  gl_Position = vec4(c.xy + off * c.w, c.z, c.w);
+  gColor = aColor;
 })";
 
 // ==========================================
-// SHADER PHONG (Ambient + Diffuse + Specular)
+// SHADER MAILLAGES (couleur unie / texture, Blinn-Phong, instanciation)
+// Variantes : TEXTURED, LIT, INSTANCED (cf. ShaderManager)
 // ==========================================
-const char* const PHONG_VS = R"(#version 330 core
+const char* const MESH_VS = R"(#version 330 core
 layout (location = 0) in vec3 aPos;
+#ifdef TEXTURED
 layout (location = 1) in vec2 aUV;
+out vec2 vUV;
+#endif
+#ifdef LIT
 layout (location = 2) in vec3 aNormal;
-
-uniform mat4 uMVP;
-uniform mat4 uModel;
-uniform mat4 uView; // Necessaire pour la speculaire (position camera)
-
 out vec3 vFragPos;
 out vec3 vNormal;
-out vec2 vUV;
+#endif
+
+#ifdef INSTANCED
+layout (location = 3) in mat4 aModel;          // une matrice par instance (locations 3..6)
+#ifdef LIT
+layout (location = 7) in mat3 aNormalMatrix;   // inverse transposée, calculée sur CPU (7..9)
+#endif
+uniform mat4 uViewProj;
+#else
+uniform mat4 uMVP;
+uniform mat4 uModel;
+#ifdef LIT
+uniform mat3 uNormalMatrix;   // inverse transposée de mat3(uModel), calculée sur CPU
+#endif
+#endif
 
 void main() {
+#ifdef INSTANCED
+    vec4 world = aModel * vec4(aPos, 1.0);
+    gl_Position = uViewProj * world;
+#else
+    gl_Position = uMVP * vec4(aPos, 1.0);
+#endif
+#ifdef TEXTURED
+    vUV = aUV;
+#endif
+#ifdef LIT
     // Position dans le monde pour l'eclairage
+#ifdef INSTANCED
+    vFragPos = world.xyz;
+    vNormal = aNormalMatrix * aNormal;
+#else
     vFragPos = vec3(uModel * vec4(aPos, 1.0));
-    
-    // Normale transformee (inverse transpose pour gerer le scale)
-    vNormal = mat3(transpose(inverse(uModel))) * aNormal;
-    
-    vUV = aUV;
-    gl_Position = uMVP * vec4(aPos, 1.0);
+    vNormal = uNormalMatrix * aNormal;
+#endif
+#endif
 }
 )";
 
-const char* const PHONG_FS = R"(#version 330 core
-in vec3 vFragPos;
-in vec3 vNormal;
-in vec2 vUV;
-
+const char* const MESH_FS = R"(#version 330 core
 out vec4 FragColor;
-
+#ifdef TEXTURED
+in vec2 vUV;
 uniform sampler2D uTex;
+#else
+uniform vec4 uColor;   // vec4 pour gerer l'alpha (ombres)
+#endif
+#ifdef LIT
+in vec3 vFragPos;
+in vec3 vNormal;
 uniform vec3 uLightPos;
 uniform vec3 uViewPos;
 uniform vec3 uLightColor;
 
-void main() {
-    // Config materiau
-    float ambientStrength = 0.4;
-    float specularStrength = 0.8;
-    float shininess = 32.0;
+// Materiau (constantes de compilation)
+const float AMBIENT = 0.4;
+const float SPECULAR = 0.8;
 
-    // 1. Ambiant
-    vec3 ambient = ambientStrength * uLightColor;
+// pow(x, 32) par elevations au carre successives
+float shine32(float x) {
+    x *= x; x *= x; x *= x; x *= x;
+    return x * x;
+}
+#endif
 
-    // 2. Diffus
+void main() {
+#ifdef TEXTURED
+    vec4 base = texture(uTex, vUV);
+#else
+    vec4 base = uColor;
+#endif
+#ifdef LIT
+    // Blinn-Phong : ambiant + diffus + speculaire
     vec3 norm = normalize(vNormal);
     vec3 lightDir = normalize(uLightPos - vFragPos);
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * uLightColor;
-
-    // 3. Speculaire (Blinn-Phong)
     vec3 viewDir = normalize(uViewPos - vFragPos);
-    vec3 halfwayDir = normalize(lightDir + viewDir);
-    float spec = pow(max(dot(norm, halfwayDir), 0.0), shininess);
-    vec3 specular = specularStrength * spec * uLightColor;
+    float diff = max(dot(norm, lightDir), 0.0);
+    float spec = shine32(max(dot(norm, normalize(lightDir + viewDir)), 0.0));
 
     // Couleur finale = Lumiere * Texture
-    vec4 texColor = texture(uTex, vUV);
-    vec3 result = (ambient + diffuse + specular) * texColor.rgb;
-    
-    FragColor = vec4(result, texColor.a);
+    base.rgb *= (AMBIENT + diff + SPECULAR * spec) * uLightColor;
+#endif
+    FragColor = base;
 }
 )";
 
 // ==========================================
-// SHADER OMBRE (Couleur unie + Transparence)
+// BALLES EN IMPOSTEURS (un quad par balle, sphère lancée de rayons)
+// Instances : centre (loc 0), rayon (loc 1), rotation (mat3, locs 2..4), cf. BallBatch
 // ==========================================
-const char* const SHADOW_VS = R"(#version 330 core
-layout (location = 0) in vec3 aPos;
-uniform mat4 uMVP;
+const char* const BALL_IMPOSTOR_VS = R"(#version 330 core
+layout (location = 0) in vec3 aCenter;
+layout (location = 1) in float aRadius;
+layout (location = 2) in mat3 aRotation;
+uniform mat4 uView;
+uniform mat4 uProj;
+out vec3 vPosVS;                 // point du quad (repère caméra)
+flat out vec3 vCenterVS;
+flat out float vRadius;
+flat out mat3 vToObject;         // repère caméra -> repère de la balle
 
 void main() {
-    gl_Position = uMVP * vec4(aPos, 1.0);
+  vec3 c = (uView * vec4(aCenter, 1.0)).xyz;
+  float d2 = dot(c, c);
+  float r2 = aRadius * aRadius;
+
+  // Quad perpendiculaire au rayon de vue, passant par le centre, assez grand
+  // pour contenir le cône tangent (silhouette exacte en perspective)
+  vec3 dir = normalize(c);
+  vec3 right = normalize(abs(dir.y) < 0.99 ? cross(dir, vec3(0.0, 1.0, 0.0)) : cross(dir, vec3(1.0, 0.0, 0.0)));
+  vec3 up = cross(right, dir);
+  float s = aRadius * sqrt(d2 / max(d2 - r2, 1e-4 * r2));
+  vec2 corner = vec2((gl_VertexID & 1) == 0 ? -1.0 : 1.0, (gl_VertexID & 2) == 0 ? -1.0 : 1.0);
+
+  vPosVS = c + (corner.x * right + corner.y * up) * s;
+  vCenterVS = c;
+  vRadius = aRadius;
+  vToObject = transpose(aRotation) * transpose(mat3(uView));
+  gl_Position = uProj * vec4(vPosVS, 1.0);
+}
+)";
+
+const char* const BALL_IMPOSTOR_FS = R"(#version 330 core
+in vec3 vPosVS;
+flat in vec3 vCenterVS;
+flat in float vRadius;
+flat in mat3 vToObject;
+out vec4 FragColor;
+uniform mat4 uProj;
+uniform sampler2D uTex;
+uniform vec3 uLightPosVS;       // lumiere dans le repere camera
+uniform vec3 uLightColor;
+
+// Materiau : memes constantes que MESH_FS (variante LIT)
+const float AMBIENT = 0.4;
+const float SPECULAR = 0.8;
+const float PI = 3.14159265;
+
+float shine32(float x) {
+    x *= x; x *= x; x *= x; x *= x;
+    return x * x;
+}
+
+void main() {
+    // Intersection rayon (depuis la camera) / sphere
+    vec3 rd = normalize(vPosVS);
+    float b = dot(rd, vCenterVS);
+    float h = b * b - dot(vCenterVS, vCenterVS) + vRadius * vRadius;
+    if (h < 0.0) discard;
+    vec3 p = rd * (b - sqrt(h));
+    vec3 n = (p - vCenterVS) / vRadius;
+
+    // Profondeur exacte du point d'impact
+    vec4 clip = uProj * vec4(p, 1.0);
+    gl_FragDepth = 0.5 * (clip.z / clip.w) + 0.5;
+
+    // UV de createSphere : x = cos(theta) sin(phi), y = cos(phi), z = sin(theta) sin(phi)
+    vec3 o = vToObject * n;
+    float v = acos(clamp(o.y, -1.0, 1.0)) / PI;
+    float uA = fract(atan(o.z, o.x) / (2.0 * PI));
+    float uB = fract(uA + 0.5) - 0.5;          // continu sur la couture de uA
+    float uG = fwidth(uA) <= fwidth(uB) ? uA : uB;
+    vec4 base = textureGrad(uTex, vec2(1.0 - uA, v), vec2(-dFdx(uG), dFdx(v)), vec2(-dFdy(uG), dFdy(v)));
+
+    // Blinn-Phong (repere camera : la camera est a l'origine)
+    vec3 lightDir = normalize(uLightPosVS - p);
+    float diff = max(dot(n, lightDir), 0.0);
+    float spec = shine32(max(dot(n, normalize(lightDir - rd)), 0.0));
+    base.rgb *= (AMBIENT + diff + SPECULAR * spec) * uLightColor;
+    FragColor = base;
+}
+)";
+
+// --- Ombres analytiques : disque flou sur le plan Z = 0, meme instances que les balles ---
+const char* const BLOB_SHADOW_VS = R"(#version 330 core
+layout (location = 0) in vec3 aCenter;
+layout (location = 1) in float aRadius;
+uniform mat4 uViewProj;
+uniform vec3 uLightPos;          // lumiere (directionnelle vers l'origine, comme shadowProj)
+out vec2 vLocal;                 // position dans le disque, [-1,1]
+flat out float vSoft;            // largeur de la penombre (fraction du rayon)
+
+void main() {
+  // Projection du centre sur Z = 0 le long de la direction de la lumiere
+  vec2 c = aCenter.xy - uLightPos.xy / uLightPos.z * aCenter.z;
+  // Penombre plus large quand la balle s'eleve ; le disque s'etend d'autant
+  vSoft = clamp(aCenter.z / (4.0 * aRadius), 0.15, 0.9);
+  float extent = aRadius * (1.0 + vSoft);
+  vLocal = vec2((gl_VertexID & 1) == 0 ? -1.0 : 1.0, (gl_VertexID & 2) == 0 ? -1.0 : 1.0);
+  gl_Position = uViewProj * vec4(c + vLocal * extent, 0.1, 1.0);
+  vLocal *= 1.0 + vSoft;
 }
 )";
 
-const char* const SHADOW_FS = R"(#version 330 core
+const char* const BLOB_SHADOW_FS = R"(#version 330 core
+in vec2 vLocal;
+flat in float vSoft;
 out vec4 FragColor;
-uniform vec4 uColor; // vec4 pour gerer l'alpha
+uniform vec4 uColor;
 
 void main() {
-    FragColor = uColor;
+  float d = length(vLocal);
+  float a = 1.0 - smoothstep(1.0 - vSoft, 1.0 + vSoft, d);
+  if (a <= 0.0) discard;
+  FragColor = vec4(uColor.rgb, uColor.a * a);
 }
 )";
 
@@ -0,0 +1,113 @@
+#include "io/capture.hpp"
+#include <opencv2/imgproc.hpp>
+#include <chrono>
+#include <utility>
+
+namespace io {
+
+double monotonicSeconds() {
+  using clock = std::chrono::steady_clock;
+  return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+cv::Size Frame::size() const {
+  switch (format) {
+    case PixelFormat::YUYV: return yuv.size();
+    case PixelFormat::NV12: return cv::Size(yuv.cols, yuv.rows * 2 / 3);
+    default:                return bgr.size();
+  }
+}
+
+void toRGBA(const Frame& frame, cv::Mat& rgba) {
+  switch (frame.format) {
+    case PixelFormat::YUYV: cv::cvtColor(frame.yuv, rgba, cv::COLOR_YUV2RGBA_YUYV); break;
+    case PixelFormat::NV12: cv::cvtColor(frame.yuv, rgba, cv::COLOR_YUV2RGBA_NV12); break;
+    default:                cv::cvtColor(frame.bgr, rgba, cv::COLOR_BGR2RGBA);      break;
+  }
+}
+
+const cv::Mat& ensureBGR(Frame& frame) {
+  switch (frame.format) {
+    case PixelFormat::YUYV: cv::cvtColor(frame.yuv, frame.bgr, cv::COLOR_YUV2BGR_YUYV); break;
+    case PixelFormat::NV12: cv::cvtColor(frame.yuv, frame.bgr, cv::COLOR_YUV2BGR_NV12); break;
+    default: break;
+  }
+  return frame.bgr;
+}
+
+/**
+ * @brief Lit une image depuis le cv::VideoCapture et l'horodate.
+ */
+bool VideoCaptureSource::read(Frame& out) {
+  if (!cap_.read(out.bgr) || out.bgr.empty()) return false;
+  out.seq = ++seq_;
+  out.timestamp = monotonicSeconds();
+  return true;
+}
+
+bool setCaptureBufferSize(cv::VideoCapture& cap, int n) {
+  if (n <= 0) return false;
+  return cap.set(cv::CAP_PROP_BUFFERSIZE, n);
+}
+
+void LatestFrameGrabber::start() {
+  if (thread_.joinable()) return;
+  stopRequested_ = false;
+  thread_ = std::thread(&LatestFrameGrabber::run, this);
+}
+
+void LatestFrameGrabber::stop() {
+  stopRequested_ = true;
+  if (thread_.joinable()) thread_.join();
+}
+
+/**
+ * @brief Boucle du thread de capture : lit dans back_, puis publie par échange avec middle_.
+ */
+void LatestFrameGrabber::run() {
+  while (!stopRequested_) {
+    // Lecture hors verrou : c'est l'appel bloquant
+    if (!src_.read(back_)) break;
+
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      std::swap(back_, middle_);
+      if (fresh_) ++stats_.dropped; // l'image précédente n'a jamais été lue
+      fresh_ = true;
+      ++stats_.captured;
+    }
+    cv_.notify_one();
+    if (onFrame_) onFrame_();
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    finished_ = true;
+  }
+  cv_.notify_all();
+  if (onFrame_) onFrame_();
+}
+
+bool LatestFrameGrabber::waitLatest(Frame& frame, int timeoutMs) {
+  std::unique_lock<std::mutex> lk(m_);
+  const bool ready = cv_.wait_for(lk, std::chrono::milliseconds(timeoutMs),
+                                  [this] { return fresh_ || finished_; });
+  if (!ready || !fresh_) return false;
+
+  std::swap(frame, middle_);
+  fresh_ = false;
+  ++stats_.delivered;
+  return true;
+}
+
+bool LatestFrameGrabber::finished() const {
+  std::lock_guard<std::mutex> lk(m_);
+  return finished_;
+}
+
+GrabberStats LatestFrameGrabber::stats() const {
+  std::lock_guard<std::mutex> lk(m_);
+  return stats_;
+}
+
+} // namespace io
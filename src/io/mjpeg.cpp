@@ -0,0 +1,180 @@
+#include "io/mjpeg.hpp"
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <iostream>
+
+#ifdef AR_HAVE_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+
+namespace io {
+
+MjpegDecoder::MjpegDecoder() {
+#ifdef AR_HAVE_TURBOJPEG
+  handle_ = tjInitDecompress();
+#endif
+}
+
+MjpegDecoder::~MjpegDecoder() {
+#ifdef AR_HAVE_TURBOJPEG
+  if (handle_) tjDestroy(static_cast<tjhandle>(handle_));
+#endif
+}
+
+bool MjpegDecoder::hasTurbo() {
+#ifdef AR_HAVE_TURBOJPEG
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool MjpegDecoder::decodeBGR(const std::uint8_t* data, std::size_t size, cv::Mat& bgr) {
+  if (!data || size == 0) return false;
+
+#ifdef AR_HAVE_TURBOJPEG
+  if (handle_) {
+    tjhandle tj = static_cast<tjhandle>(handle_);
+    int w = 0, h = 0, subsamp = 0, colorspace = 0;
+    unsigned char* src = const_cast<unsigned char*>(data);
+    if (tjDecompressHeader3(tj, src, (unsigned long)size, &w, &h, &subsamp, &colorspace) != 0)
+      return false;
+
+    bgr.create(h, w, CV_8UC3);
+    return tjDecompress2(tj, src, (unsigned long)size, bgr.data, w, (int)bgr.step, h,
+                         TJPF_BGR, TJFLAG_FASTDCT) == 0;
+  }
+#endif
+
+  cv::Mat buf(1, (int)size, CV_8UC1, const_cast<std::uint8_t*>(data));
+  cv::Mat out = cv::imdecode(buf, cv::IMREAD_COLOR);
+  if (out.empty()) return false;
+  bgr = out;
+  return true;
+}
+
+// Luminance de détection à partir d'un plan pleine résolution (copie : le plan est réutilisé)
+static void reduceLuma(const cv::Mat& y, int denom, cv::Mat& luma) {
+  if (denom == 1) { y.copyTo(luma); return; }
+  const cv::Size size((y.cols + denom - 1) / denom, (y.rows + denom - 1) / denom);
+  cv::resize(y, luma, size, 0, 0, cv::INTER_AREA);
+}
+
+bool MjpegDecoder::decode(const std::uint8_t* data, std::size_t size, int lumaDenom,
+                          cv::Mat& bgr, cv::Mat& luma) {
+  if (!data || size == 0) return false;
+  if (lumaDenom != 0 && lumaDenom != 1 && lumaDenom != 2 && lumaDenom != 4 && lumaDenom != 8)
+    return false;
+
+#ifdef AR_HAVE_TURBOJPEG
+  if (handle_) {
+    tjhandle tj = static_cast<tjhandle>(handle_);
+    int w = 0, h = 0, subsamp = 0, colorspace = 0;
+    unsigned char* src = const_cast<unsigned char*>(data);
+    if (tjDecompressHeader3(tj, src, (unsigned long)size, &w, &h, &subsamp, &colorspace) != 0)
+      return false;
+
+    // Décodage entropique + IDCT une seule fois, vers les plans YCbCr
+    const int nPlanes = subsamp == TJSAMP_GRAY ? 1 : 3;
+    int strides[3] = {0, 0, 0}, heights[3] = {0, 0, 0};
+    std::size_t total = 0;
+    for (int c = 0; c < nPlanes; ++c) {
+      strides[c] = tjPlaneWidth(c, w, subsamp);
+      heights[c] = tjPlaneHeight(c, h, subsamp);
+      if (strides[c] <= 0 || heights[c] <= 0) return false;
+      total += (std::size_t)strides[c] * heights[c];
+    }
+    planes_.create(1, (int)total, CV_8UC1);
+    unsigned char* planes[3] = {planes_.data, nullptr, nullptr};
+    for (int c = 1; c < nPlanes; ++c) planes[c] = planes[c - 1] + (std::size_t)strides[c - 1] * heights[c - 1];
+    if (tjDecompressToYUVPlanes(tj, src, (unsigned long)size, planes, w, strides, h, TJFLAG_FASTDCT) != 0)
+      return false;
+
+    // Conversion couleur seule (pas de second décodage)
+    bgr.create(h, w, CV_8UC3);
+    if (tjDecodeYUVPlanes(tj, const_cast<const unsigned char**>(planes), strides, subsamp,
+                          bgr.data, w, (int)bgr.step, h, TJPF_BGR, 0) != 0)
+      return false;
+
+    if (lumaDenom > 0) reduceLuma(cv::Mat(h, w, CV_8UC1, planes[0], (std::size_t)strides[0]), lumaDenom, luma);
+    else               luma.release();
+    return true;
+  }
+#endif
+
+  cv::Mat buf(1, (int)size, CV_8UC1, const_cast<std::uint8_t*>(data));
+  cv::Mat out = cv::imdecode(buf, cv::IMREAD_COLOR);
+  if (out.empty()) return false;
+  bgr = out;
+  if (lumaDenom > 0) {
+    cv::cvtColor(bgr, planes_, cv::COLOR_BGR2GRAY);
+    reduceLuma(planes_, lumaDenom, luma);
+  } else {
+    luma.release();
+  }
+  return true;
+}
+
+bool MjpegDecoder::decodeGray(const std::uint8_t* data, std::size_t size, int denom, cv::Mat& gray) {
+  if (!data || size == 0) return false;
+  if (denom != 1 && denom != 2 && denom != 4 && denom != 8) return false;
+
+#ifdef AR_HAVE_TURBOJPEG
+  if (handle_) {
+    tjhandle tj = static_cast<tjhandle>(handle_);
+    int w = 0, h = 0, subsamp = 0, colorspace = 0;
+    unsigned char* src = const_cast<unsigned char*>(data);
+    if (tjDecompressHeader3(tj, src, (unsigned long)size, &w, &h, &subsamp, &colorspace) != 0)
+      return false;
+
+    // Sortie TJPF_GRAY : libjpeg ne reconstruit que la composante Y,
+    // et la réduction 1/denom est faite dans l'IDCT (blocs 8x8 -> 8/denom).
+    const tjscalingfactor sf{1, denom};
+    const int sw = TJSCALED(w, sf), sh = TJSCALED(h, sf);
+    gray.create(sh, sw, CV_8UC1);
+    return tjDecompress2(tj, src, (unsigned long)size, gray.data, sw, (int)gray.step, sh,
+                         TJPF_GRAY, TJFLAG_FASTDCT) == 0;
+  }
+#endif
+
+  int flags = cv::IMREAD_GRAYSCALE;
+  if (denom == 2) flags = cv::IMREAD_REDUCED_GRAYSCALE_2;
+  if (denom == 4) flags = cv::IMREAD_REDUCED_GRAYSCALE_4;
+  if (denom == 8) flags = cv::IMREAD_REDUCED_GRAYSCALE_8;
+  cv::Mat buf(1, (int)size, CV_8UC1, const_cast<std::uint8_t*>(data));
+  cv::Mat out = cv::imdecode(buf, flags);
+  if (out.empty()) return false;
+  gray = out;
+  return true;
+}
+
+MjpegCaptureSource::MjpegCaptureSource(cv::VideoCapture& cap, int lumaDenom)
+  : cap_(cap), lumaDenom_(lumaDenom) {}
+
+/**
+ * @brief Récupère le JPEG brut du driver puis le décode une fois (couleur + luminance réduite).
+ */
+bool MjpegCaptureSource::read(Frame& out) {
+  // En mode brut, OpenCV rend le tampon compressé sous forme de vecteur d'octets
+  for (;;) {
+    if (!cap_.read(raw_) || raw_.empty()) return false;
+    const std::size_t size = raw_.total() * raw_.elemSize();
+    if (decoder_.decode(raw_.ptr<std::uint8_t>(), size, lumaDenom_, out.bgr, out.luma)) break;
+    // Trame abîmée (USB) : on passe à la suivante sans couper le flux
+    std::cerr << "[WARN] Image MJPEG corrompue ignorée\n";
+  }
+  out.format = PixelFormat::BGR;
+  out.lumaDenom = lumaDenom_ > 0 ? lumaDenom_ : 1;
+
+  out.seq = ++seq_;
+  out.timestamp = monotonicSeconds();
+  return true;
+}
+
+bool enableRawMjpeg(cv::VideoCapture& cap) {
+  const int fourcc = (int)cap.get(cv::CAP_PROP_FOURCC);
+  if (fourcc != cv::VideoWriter::fourcc('M','J','P','G')) return false;
+  return cap.set(cv::CAP_PROP_CONVERT_RGB, 0);
+}
+
+} // namespace io
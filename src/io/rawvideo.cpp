@@ -0,0 +1,313 @@
+#include "io/rawvideo.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef AR_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+namespace io {
+
+static_assert(sizeof(RawFileHeader) <= RAW_ALIGN, "en-tête de fichier trop grand");
+static_assert(sizeof(RawRecordHeader) <= RAW_PAYLOAD_OFFSET, "en-tête d'enregistrement trop grand");
+
+static std::size_t alignUp(std::size_t n, std::size_t a) { return (n + a - 1) / a * a; }
+
+// ============================================================
+//  ÉCRITURE
+// ============================================================
+
+RawVideoWriter::~RawVideoWriter() { close(); }
+
+bool RawVideoWriter::hasLz4() {
+#ifdef AR_HAVE_LZ4
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Crée le fichier et écrit le bloc d'en-tête dans le tampon.
+ */
+bool RawVideoWriter::open(const std::string& path, cv::Size size, int cvType, double fps,
+                          bool lz4, std::size_t chunkBytes) {
+  close();
+
+  // O_DIRECT évite de polluer le cache de pages avec des Go de vidéo ;
+  // certains systèmes de fichiers (tmpfs) le refusent : on retombe sur une écriture normale.
+#ifdef O_DIRECT
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+  direct_ = fd_ >= 0;
+#endif
+  if (fd_ < 0) fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) return false;
+
+  chunkBytes_ = alignUp(std::max<std::size_t>(chunkBytes, RAW_ALIGN), RAW_ALIGN);
+  chunk_ = static_cast<std::uint8_t*>(std::aligned_alloc(RAW_ALIGN, chunkBytes_));
+  if (!chunk_) { ::close(fd_); fd_ = -1; return false; }
+  chunkUsed_ = 0;
+  fileBytes_ = 0;
+
+  header_ = RawFileHeader{};
+  std::memcpy(header_.magic, "ARRAWV01", 8);
+  header_.version = 1;
+  header_.flags = (lz4 && hasLz4()) ? RAW_FLAG_LZ4 : 0u;
+  header_.width = size.width;
+  header_.height = size.height;
+  header_.cvType = cvType;
+  header_.frameBytes = (std::uint64_t)size.area() * CV_ELEM_SIZE(cvType);
+  header_.frameCount = 0;
+  header_.fps = fps;
+
+  std::memset(chunk_, 0, RAW_ALIGN);
+  std::memcpy(chunk_, &header_, sizeof(header_));
+  chunkUsed_ = RAW_ALIGN;
+  return true;
+}
+
+bool RawVideoWriter::flush() {
+  std::size_t done = 0;
+  while (done < chunkUsed_) {
+    const ssize_t n = ::write(fd_, chunk_ + done, chunkUsed_ - done);
+    if (n <= 0) return false;
+    done += (std::size_t)n;
+  }
+  fileBytes_ += chunkUsed_;
+  chunkUsed_ = 0;
+  return true;
+}
+
+/**
+ * @brief Ajoute un enregistrement [en-tête | pixels | bourrage] au tampon.
+ */
+bool RawVideoWriter::write(const cv::Mat& img, double timestamp) {
+  if (fd_ < 0) return false;
+  if (img.cols != header_.width || img.rows != header_.height || img.type() != header_.cvType)
+    return false;
+
+  const cv::Mat src = img.isContinuous() ? img : img.clone();
+  const std::uint8_t* payload = src.ptr<std::uint8_t>();
+  std::size_t payloadBytes = (std::size_t)header_.frameBytes;
+  std::uint32_t recFlags = 0;
+
+#ifdef AR_HAVE_LZ4
+  if (header_.flags & RAW_FLAG_LZ4) {
+    scratch_.resize((std::size_t)LZ4_compressBound((int)payloadBytes));
+    const int n = LZ4_compress_default(reinterpret_cast<const char*>(payload), scratch_.data(),
+                                       (int)payloadBytes, (int)scratch_.size());
+    if (n <= 0) return false;
+    payload = reinterpret_cast<const std::uint8_t*>(scratch_.data());
+    payloadBytes = (std::size_t)n;
+    recFlags = RAW_FLAG_LZ4;
+  }
+#endif
+
+  RawRecordHeader rh{};
+  rh.magic = RAW_RECORD_MAGIC;
+  rh.flags = recFlags;
+  rh.seq = header_.frameCount + 1;
+  rh.timestamp = timestamp;
+  rh.payloadBytes = payloadBytes;
+  rh.recordBytes = alignUp(RAW_PAYLOAD_OFFSET + payloadBytes, RAW_ALIGN);
+
+  // Copie par morceaux dans le tampon aligné, écrit dès qu'il est plein
+  std::uint8_t head[RAW_PAYLOAD_OFFSET] = {};
+  std::memcpy(head, &rh, sizeof(rh));
+  const std::uint8_t* parts[2] = { head, payload };
+  const std::size_t sizes[2] = { RAW_PAYLOAD_OFFSET, payloadBytes };
+  for (int k = 0; k < 2; ++k) {
+    std::size_t off = 0;
+    while (off < sizes[k]) {
+      const std::size_t n = std::min(sizes[k] - off, chunkBytes_ - chunkUsed_);
+      std::memcpy(chunk_ + chunkUsed_, parts[k] + off, n);
+      chunkUsed_ += n; off += n;
+      if (chunkUsed_ == chunkBytes_ && !flush()) return false;
+    }
+  }
+
+  // Bourrage jusqu'à la frontière d'alignement (les fins d'enregistrement tombent sur RAW_ALIGN)
+  const std::size_t pad = (std::size_t)rh.recordBytes - RAW_PAYLOAD_OFFSET - payloadBytes;
+  std::memset(chunk_ + chunkUsed_, 0, pad);   // pad < RAW_ALIGN <= place restante
+  chunkUsed_ += pad;
+  if (chunkUsed_ == chunkBytes_ && !flush()) return false;
+
+  ++header_.frameCount;
+  return true;
+}
+
+/**
+ * @brief Vide le tampon et réécrit l'en-tête avec le nombre d'images final.
+ */
+void RawVideoWriter::close() {
+  if (fd_ >= 0) {
+    flush();
+    // Réécriture du premier bloc (tampon aligné, compatible O_DIRECT)
+    std::memset(chunk_, 0, RAW_ALIGN);
+    std::memcpy(chunk_, &header_, sizeof(header_));
+    if (::pwrite(fd_, chunk_, RAW_ALIGN, 0) != (ssize_t)RAW_ALIGN) {
+      // En-tête non mis à jour : le lecteur recompte les enregistrements de toute façon
+    }
+    ::close(fd_);
+    fd_ = -1;
+  }
+  std::free(chunk_);
+  chunk_ = nullptr;
+  chunkUsed_ = 0;
+}
+
+// ============================================================
+//  LECTURE
+// ============================================================
+
+RawVideoReader::~RawVideoReader() { close(); }
+
+void RawVideoReader::close() {
+  map_.reset();
+  mapBytes_ = 0;
+  offsets_.clear();
+  decoded_.release();
+}
+
+/**
+ * @brief Projette le fichier et indexe les enregistrements.
+ *
+ * L'index est reconstruit en sautant d'enregistrement en enregistrement :
+ * un fichier tronqué (enregistreur interrompu) reste lisible jusqu'à la
+ * dernière image complète.
+ */
+void RawVideoReader::open(const std::string& path) {
+  close();
+
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("Impossible d'ouvrir " + path);
+  struct stat st{};
+  if (fstat(fd, &st) != 0 || (std::size_t)st.st_size < RAW_ALIGN) {
+    ::close(fd);
+    throw std::runtime_error("Fichier brut invalide : " + path);
+  }
+  const std::size_t bytes = (std::size_t)st.st_size;
+  void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) throw std::runtime_error("mmap impossible : " + path);
+  madvise(p, bytes, MADV_SEQUENTIAL);
+
+  map_ = std::shared_ptr<void>(p, [bytes](void* q) { munmap(q, bytes); });
+  mapBytes_ = bytes;
+
+  const auto* base = static_cast<const std::uint8_t*>(p);
+  std::memcpy(&header_, base, sizeof(header_));
+  // La taille d'image doit correspondre au type : frame() / decode() s'y fient
+  if (std::memcmp(header_.magic, "ARRAWV01", 8) != 0 || header_.version != 1 ||
+      header_.width <= 0 || header_.height <= 0 || header_.cvType < 0 ||
+      header_.frameBytes != (std::uint64_t)header_.width * (std::uint64_t)header_.height *
+                                (std::uint64_t)CV_ELEM_SIZE(header_.cvType) ||
+      header_.frameBytes > (std::uint64_t)INT_MAX) {
+    close();
+    throw std::runtime_error("En-tête .arv invalide : " + path);
+  }
+#ifndef AR_HAVE_LZ4
+  if (header_.flags & RAW_FLAG_LZ4) {
+    close();
+    throw std::runtime_error("Fichier compressé LZ4 mais binaire compilé sans LZ4 : " + path);
+  }
+#endif
+
+  // Premier enregistrement invalide = fin de l'index (fichier tronqué ou corrompu).
+  // Tailles comparées par soustraction : pas de débordement avec des valeurs forgées.
+  std::size_t off = RAW_ALIGN;
+  while (RAW_PAYLOAD_OFFSET <= bytes - off) {
+    const auto* rh = reinterpret_cast<const RawRecordHeader*>(base + off);
+    if (rh->magic != RAW_RECORD_MAGIC || rh->recordBytes == 0 || rh->recordBytes > bytes - off)
+      break;
+    // La charge utile doit tenir dans l'enregistrement ; non compressée, c'est une image entière
+    if (rh->recordBytes < RAW_PAYLOAD_OFFSET || rh->payloadBytes > rh->recordBytes - RAW_PAYLOAD_OFFSET)
+      break;
+    if (rh->flags & RAW_FLAG_LZ4) {
+      if (rh->payloadBytes > (std::uint64_t)INT_MAX) break;
+    } else if (rh->payloadBytes != header_.frameBytes) {
+      break;
+    }
+    offsets_.push_back(off);
+    off += (std::size_t)rh->recordBytes;
+  }
+}
+
+const RawRecordHeader& RawVideoReader::record(std::size_t i) const {
+  const auto* base = static_cast<const std::uint8_t*>(map_.get());
+  return *reinterpret_cast<const RawRecordHeader*>(base + offsets_.at(i));
+}
+
+cv::Mat RawVideoReader::frame(std::size_t i) {
+  const RawRecordHeader& rh = record(i);
+  if (rh.flags & RAW_FLAG_LZ4) {
+    decode(i, decoded_);
+    return decoded_;
+  }
+  auto* px = const_cast<std::uint8_t*>(reinterpret_cast<const std::uint8_t*>(&rh) + RAW_PAYLOAD_OFFSET);
+  return cv::Mat(header_.height, header_.width, header_.cvType, px);
+}
+
+void RawVideoReader::decode(std::size_t i, cv::Mat& dst) {
+  const RawRecordHeader& rh = record(i);
+  const auto* px = reinterpret_cast<const std::uint8_t*>(&rh) + RAW_PAYLOAD_OFFSET;
+
+  // dst ne doit pas être une vue sur la projection (lecture seule)
+  const auto* base = static_cast<const std::uint8_t*>(map_.get());
+  if (dst.data >= base && dst.data < base + mapBytes_) dst.release();
+  dst.create(header_.height, header_.width, header_.cvType);
+
+#ifdef AR_HAVE_LZ4
+  if (rh.flags & RAW_FLAG_LZ4) {
+    const int n = LZ4_decompress_safe(reinterpret_cast<const char*>(px), reinterpret_cast<char*>(dst.data),
+                                      (int)rh.payloadBytes, (int)header_.frameBytes);
+    if (n != (int)header_.frameBytes)
+      throw std::runtime_error("Image LZ4 corrompue");
+    return;
+  }
+#endif
+  std::memcpy(dst.data, px, (std::size_t)header_.frameBytes);
+}
+
+// ============================================================
+//  SOURCE POUR L'APPLICATION AR
+// ============================================================
+
+RawVideoSource::RawVideoSource(const std::string& path) {
+  reader_.open(path);
+  if (reader_.type() != CV_8UC3)
+    throw std::runtime_error("Rejeu AR : le fichier brut doit contenir des images BGR (CV_8UC3)");
+}
+
+/**
+ * @brief Image suivante : vue directe sur la projection si non compressée.
+ */
+bool RawVideoSource::read(Frame& out) {
+  if (next_ >= reader_.frameCount()) return false;
+
+  const RawRecordHeader& rh = reader_.record(next_);
+  if (rh.flags & RAW_FLAG_LZ4) {
+    out.owner.reset();
+    reader_.decode(next_, out.bgr);
+  } else {
+    out.bgr = reader_.frame(next_);
+    out.owner = reader_.mapping();
+  }
+  out.format = PixelFormat::BGR;
+  out.luma.release();
+  out.lumaDenom = 1;
+  out.seq = rh.seq;
+  out.timestamp = monotonicSeconds(); // latence mesurée depuis la lecture
+  ++next_;
+  return true;
+}
+
+} // namespace io
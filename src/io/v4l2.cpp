@@ -0,0 +1,225 @@
+#include "io/v4l2.hpp"
+#include <opencv2/core.hpp>
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/select.h>
+#include <unistd.h>
+#endif
+
+namespace io {
+
+#ifdef __linux__
+
+// ioctl relancé si interrompu par un signal
+static int xioctl(int fd, unsigned long req, void* arg) {
+  int r;
+  do { r = ioctl(fd, req, arg); } while (r == -1 && errno == EINTR);
+  return r;
+}
+
+struct V4l2Source::Impl {
+  struct Buffer { void* start = MAP_FAILED; size_t length = 0; };
+
+  int fd = -1;
+  std::vector<Buffer> buffers;
+  PixelFormat format = PixelFormat::YUYV;
+  int width = 0, height = 0, bytesPerLine = 0;
+  double fps = 0.0;
+  bool streaming = false;
+
+  ~Impl() {
+    if (streaming) {
+      v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+      xioctl(fd, VIDIOC_STREAMOFF, &type);
+    }
+    for (auto& b : buffers)
+      if (b.start != MAP_FAILED) munmap(b.start, b.length);
+    if (fd >= 0) close(fd);
+  }
+
+  // Rend un tampon au driver (appelé par le dernier Frame::owner)
+  void requeue(std::uint32_t index) {
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = index;
+    xioctl(fd, VIDIOC_QBUF, &buf);
+  }
+};
+
+V4l2Source::V4l2Source() = default;
+V4l2Source::~V4l2Source() = default;
+
+/**
+ * @brief Ouvre le périphérique et prépare les tampons mmap.
+ */
+void V4l2Source::open(const V4l2Config& cfg) {
+  auto impl = std::make_shared<Impl>();
+
+  impl->fd = ::open(cfg.device.c_str(), O_RDWR | O_NONBLOCK);
+  if (impl->fd < 0)
+    throw std::runtime_error("V4L2 : impossible d'ouvrir " + cfg.device);
+
+  v4l2_capability caps{};
+  if (xioctl(impl->fd, VIDIOC_QUERYCAP, &caps) < 0 ||
+      !(caps.capabilities & V4L2_CAP_VIDEO_CAPTURE) ||
+      !(caps.capabilities & V4L2_CAP_STREAMING))
+    throw std::runtime_error("V4L2 : " + cfg.device + " ne supporte pas la capture en streaming");
+
+  // --- Format : NV12 / YUYV (le détecteur n'a besoin que de Y) ---
+  std::vector<std::uint32_t> candidates = { V4L2_PIX_FMT_YUYV, V4L2_PIX_FMT_NV12 };
+  if (cfg.preferNV12) std::swap(candidates[0], candidates[1]);
+
+  v4l2_format fmt{};
+  bool formatOk = false;
+  for (std::uint32_t pix : candidates) {
+    fmt = v4l2_format{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = cfg.width;
+    fmt.fmt.pix.height = cfg.height;
+    fmt.fmt.pix.pixelformat = pix;
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    if (xioctl(impl->fd, VIDIOC_S_FMT, &fmt) == 0 && fmt.fmt.pix.pixelformat == pix) {
+      formatOk = true;
+      break;
+    }
+  }
+  if (!formatOk)
+    throw std::runtime_error("V4L2 : ni YUYV ni NV12 disponibles sur " + cfg.device);
+
+  impl->format = (fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_NV12) ? PixelFormat::NV12 : PixelFormat::YUYV;
+  impl->width = (int)fmt.fmt.pix.width;
+  impl->height = (int)fmt.fmt.pix.height;
+  impl->bytesPerLine = (int)fmt.fmt.pix.bytesperline;
+
+  // --- Cadence ---
+  v4l2_streamparm parm{};
+  parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  parm.parm.capture.timeperframe.numerator = 1;
+  parm.parm.capture.timeperframe.denominator = cfg.fps;
+  if (xioctl(impl->fd, VIDIOC_S_PARM, &parm) == 0 && parm.parm.capture.timeperframe.numerator > 0)
+    impl->fps = (double)parm.parm.capture.timeperframe.denominator / parm.parm.capture.timeperframe.numerator;
+  else
+    impl->fps = cfg.fps;
+
+  // --- Tampons mmap ---
+  v4l2_requestbuffers req{};
+  req.count = cfg.bufferCount;
+  req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  req.memory = V4L2_MEMORY_MMAP;
+  if (xioctl(impl->fd, VIDIOC_REQBUFS, &req) < 0 || req.count < 3)
+    throw std::runtime_error("V4L2 : VIDIOC_REQBUFS refusé");
+
+  impl->buffers.resize(req.count);
+  for (std::uint32_t i = 0; i < req.count; ++i) {
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = i;
+    if (xioctl(impl->fd, VIDIOC_QUERYBUF, &buf) < 0)
+      throw std::runtime_error("V4L2 : VIDIOC_QUERYBUF refusé");
+
+    impl->buffers[i].length = buf.length;
+    impl->buffers[i].start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                                  impl->fd, buf.m.offset);
+    if (impl->buffers[i].start == MAP_FAILED)
+      throw std::runtime_error("V4L2 : mmap impossible");
+
+    if (xioctl(impl->fd, VIDIOC_QBUF, &buf) < 0)
+      throw std::runtime_error("V4L2 : VIDIOC_QBUF refusé");
+  }
+
+  v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  if (xioctl(impl->fd, VIDIOC_STREAMON, &type) < 0)
+    throw std::runtime_error("V4L2 : VIDIOC_STREAMON refusé");
+  impl->streaming = true;
+
+  impl_ = std::move(impl);
+  seq_ = 0;
+}
+
+/**
+ * @brief Récupère le prochain tampon rempli et l'expose sans copie.
+ */
+bool V4l2Source::read(Frame& out) {
+  if (!impl_) return false;
+
+  // Le tampon précédemment porté par ce Frame retourne au driver
+  out.owner.reset();
+
+  // Attente d'une image (2 s max, sinon on considère le flux coupé)
+  for (;;) {
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(impl_->fd, &fds);
+    timeval tv{2, 0};
+    const int r = select(impl_->fd + 1, &fds, nullptr, nullptr, &tv);
+    if (r > 0) break;
+    if (r < 0 && errno == EINTR) continue;
+    return false;
+  }
+
+  v4l2_buffer buf{};
+  buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  buf.memory = V4L2_MEMORY_MMAP;
+  if (xioctl(impl_->fd, VIDIOC_DQBUF, &buf) < 0) return false;
+
+  std::shared_ptr<Impl> impl = impl_;
+  const std::uint32_t index = buf.index;
+  auto* data = static_cast<std::uint8_t*>(impl->buffers[index].start);
+  out.owner = std::shared_ptr<void>(data, [impl, index](void*) { impl->requeue(index); });
+
+  const int w = impl->width, h = impl->height;
+  const size_t stride = (size_t)impl->bytesPerLine;
+  out.format = impl->format;
+  out.bgr.release();
+  if (impl->format == PixelFormat::NV12) {
+    out.yuv  = cv::Mat(h * 3 / 2, w, CV_8UC1, data, stride);
+    out.luma = cv::Mat(h, w, CV_8UC1, data, stride);   // plan Y : vue directe
+  } else {
+    out.yuv = cv::Mat(h, w, CV_8UC2, data, stride);
+    cv::extractChannel(out.yuv, out.luma, 0);          // Y0 U Y1 V -> octets pairs
+  }
+  out.lumaDenom = 1;
+
+  out.seq = ++seq_;
+  if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC)
+    out.timestamp = buf.timestamp.tv_sec + buf.timestamp.tv_usec * 1e-6;
+  else
+    out.timestamp = monotonicSeconds();
+  return true;
+}
+
+int V4l2Source::width() const  { return impl_ ? impl_->width : 0; }
+int V4l2Source::height() const { return impl_ ? impl_->height : 0; }
+double V4l2Source::fps() const { return impl_ ? impl_->fps : 0.0; }
+PixelFormat V4l2Source::format() const { return impl_ ? impl_->format : PixelFormat::YUYV; }
+
+#else // !__linux__
+
+struct V4l2Source::Impl {};
+
+V4l2Source::V4l2Source() = default;
+V4l2Source::~V4l2Source() = default;
+
+void V4l2Source::open(const V4l2Config&) {
+  throw std::runtime_error("V4L2 : backend disponible uniquement sous Linux");
+}
+
+bool V4l2Source::read(Frame&) { return false; }
+int V4l2Source::width() const  { return 0; }
+int V4l2Source::height() const { return 0; }
+double V4l2Source::fps() const { return 0.0; }
+PixelFormat V4l2Source::format() const { return PixelFormat::YUYV; }
+
+#endif
+
+} // namespace io
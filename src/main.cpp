@@ -6,15 +6,32 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "ar/calib.hpp"           // Chargement des paramètres de calibration
+#include "ar/calibcache.hpp"      // Cache binaire de calibration (mmap)
 #include "ar/pose.hpp"            // Projection / View OpenGL à partir de rvec/tvec
 #include "detect/a4.hpp"          // Détection des coins de la feuille A4
+#include "detect/motion.hpp"      // Saut de la détection sur scène fixe
+#include "glx/ballbatch.hpp"      // Balles en imposteurs (instances)
+#include "glx/dynres.hpp"         // Résolution dynamique de la couche 3D
+#include "glx/linebatch.hpp"      // Lignes épaisses instanciées (débogage)
 #include "glx/mesh.hpp"           // Création des maillages 3D
-#include "glx/shaders.hpp"        // Compilation / linkage des shaders
+#include "glx/meshcache.hpp"      // Maillages partagés + LOD de la balle
+#include "glx/renderqueue.hpp"    // File de rendu triée par état
+#include "glx/shaders.hpp"        // Sources GLSL
+#include "glx/shadermanager.hpp"  // Variantes de shaders + cache des binaires
 #include "glx/texture.hpp"        // Gestion de la texture
 #include "ar/physics.hpp"        // Gestion des collisions
-#include "glx/cleanup.hpp"        // Nettoyage à la fin
-
+#include "ar/quality.hpp"        // Contrôleur de qualité (budget par image)
+#include "glx/resource.hpp"       // Poignées RAII + registre des ressources GPU
+#include "io/capture.hpp"         // Capture sur thread dédié (dernière image gagne)
+#include "io/mjpeg.hpp"           // Décodage MJPEG hors OpenCV (libjpeg-turbo)
+#include "io/v4l2.hpp"            // Backend V4L2 natif (mmap, sans copie)
+#include "io/rawvideo.hpp"        // Rejeu des enregistrements bruts .arv (mmap)
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
@@ -27,11 +44,55 @@ int main(int argc, char** argv) {
     std::string videoPath = "../data/Video_AR_1.mp4";       // Par défaut : chemin de la vidéo  
     std::string phoneUrl  = "";                         // URL pour DroidCam
     cv::VideoCapture cap;
+    std::string rawPath   = "";                         // Enregistrement brut .arv
     bool useWebcam = false;
     bool usePhone  = false;
+    // --- Options (reconnues n'importe où sur la ligne de commande) ---
+    std::vector<std::string> args(argv + 1, argv + argc);
+    auto takeFlag = [&args](const std::string& name) {
+        auto it = std::find(args.begin(), args.end(), name);
+        if (it == args.end()) return false;
+        args.erase(it);
+        return true;
+    };
+    auto takeInt = [&args](const std::string& name, int def) {
+        auto it = std::find(args.begin(), args.end(), name);
+        if (it == args.end() || it + 1 == args.end()) return def;
+        int v = def;
+        try { v = std::stoi(*(it + 1)); } catch (...) {}
+        args.erase(it, it + 2);
+        return v;
+    };
+    // --sync-capture : lecture bloquante dans la boucle (ancien comportement)
+    bool syncCapture = takeFlag("--sync-capture");
+    // --buffersize N : CAP_PROP_BUFFERSIZE du driver (0 = valeur par défaut du backend)
+    int bufferSize = takeInt("--buffersize", 0);
+    // --mjpeg-raw : webcam MJPG décodée par libjpeg-turbo au lieu d'OpenCV
+    bool mjpegRaw = takeFlag("--mjpeg-raw");
+    // --luma-denom N : luminance réduite 1/N (1,2,4,8) produite au décodage pour la détection
+    int lumaDenom = takeInt("--luma-denom", 0);
+    if (lumaDenom != 0 && lumaDenom != 1 && lumaDenom != 2 && lumaDenom != 4 && lumaDenom != 8) {
+        std::cerr << "--luma-denom : valeur attendue 0, 1, 2, 4 ou 8 (reçu " << lumaDenom << ")\n";
+        return -1;
+    }
+    // --v4l2 : webcam via le backend V4L2 natif (YUYV/NV12 mmap) au lieu de cv::VideoCapture
+    bool useV4l2 = takeFlag("--v4l2");
+    // --undistort : corrige la distorsion de l'image (LUT précalculées, mises en cache)
+    bool undistort = takeFlag("--undistort");
+    // --impostors : balles en imposteurs (un quad lancé de rayons) et ombres analytiques
+    bool impostors = takeFlag("--impostors");
+    // --render-budget MS : budget GPU de la couche 3D (résolution dynamique ; 0 = pleine résolution)
+    int renderBudgetMs = takeInt("--render-budget", 8);
+    // --render-scale-min P : échelle minimale de la couche 3D, en pourcents
+    int renderScaleMin = takeInt("--render-scale-min", 50);
+    // --target-fps N : budget par image du contrôleur de qualité (0 = qualité maximale fixe)
+    int targetFps = takeInt("--target-fps", 30);
+    // --motion-refresh N : scène fixe, coins et pose réutilisés au plus N images d'affilée (0 = toujours détecter)
+    int motionRefresh = takeInt("--motion-refresh", 30);
+
     // --- Interprétation des arguments ---
-    if (argc > 1) {
-        std::string arg1 = argv[1];
+    if (!args.empty()) {
+        const std::string& arg1 = args[0];
 
         if (arg1 == "--webcam") {
             useWebcam = true;
@@ -39,24 +100,33 @@ int main(int argc, char** argv) {
         } 
         else if (arg1 == "--phone") {
             // Usage: ./AR_A4_Video --phone http://192.168.1.47:4747/video
-            if (argc < 3) {
+            if (args.size() < 2) {
                 std::cerr << "Usage: ./AR_A4_Video --phone <url_droidcam>\n"
                           << "Exemple: http://192.168.1.15:4747/video\n";
                 return -1;
             }
             usePhone = true;
-            phoneUrl = argv[2];
+            phoneUrl = args[1];
             // On garde camera.yaml ou on en crée un camera_phone.yaml si besoin
             calibPath = "../data/camera.yaml"; 
         }
         else if (arg1 == "--video") {
-            if (argc < 4) {
+            if (args.size() < 3) {
                 std::cerr << "Usage: ./AR_A4_Video --video <video_path> <calibration_path>\n";
                 return -1;
             }
-            videoPath = argv[2];
-            calibPath = argv[3];
+            videoPath = args[1];
+            calibPath = args[2];
         } 
+        else if (arg1 == "--raw") {
+            // Enregistrement brut sans perte (RecordVideo --raw), rejoué sans décodage
+            if (args.size() < 3) {
+                std::cerr << "Usage: ./AR_A4_Video --raw <capture.arv> <calibration_path>\n";
+                return -1;
+            }
+            rawPath   = args[1];
+            calibPath = args[2];
+        }
         else {
             std::cerr << "Argument inconnu : " << arg1 << "\n";
             return -1;
@@ -64,7 +134,17 @@ int main(int argc, char** argv) {
     }
 
     // --- Ouverture de la source vidéo ---
-    if (useWebcam) {
+    std::unique_ptr<io::FrameSource> source;
+    if (useWebcam && useV4l2) {
+        auto v4l2 = std::make_unique<io::V4l2Source>();
+        io::V4l2Config cfg;                 // /dev/video0, 1280x720 @ 30
+        v4l2->open(cfg);
+        std::cout << "[INFO] V4L2 natif => " << v4l2->width() << "x" << v4l2->height()
+                  << " @ " << v4l2->fps() << " FPS ("
+                  << (v4l2->format() == io::PixelFormat::NV12 ? "NV12" : "YUYV") << ", mmap)\n";
+        source = std::move(v4l2);
+    }
+    else if (useWebcam) {
         int camIndex = 0;
         int reqW = 1280, reqH = 720, reqFPS = 30;
 
@@ -89,6 +169,9 @@ int main(int argc, char** argv) {
             cap.set(cv::CAP_PROP_FPS,          reqFPS);
         }
 
+        if (bufferSize > 0 && !io::setCaptureBufferSize(cap, bufferSize))
+            std::cerr << "[WARN] CAP_PROP_BUFFERSIZE=" << bufferSize << " refusé par le backend\n";
+
         std::cout << "[INFO] Webcam ouverte => "
                   << (int)cap.get(cv::CAP_PROP_FRAME_WIDTH) << "x"
                   << (int)cap.get(cv::CAP_PROP_FRAME_HEIGHT) << " @ "
@@ -104,9 +187,19 @@ int main(int argc, char** argv) {
             return -1;
         }
         
+        if (bufferSize > 0 && !io::setCaptureBufferSize(cap, bufferSize))
+            std::cerr << "[WARN] CAP_PROP_BUFFERSIZE=" << bufferSize << " refusé par le backend\n";
+
         // Parfois DroidCam démarre lentement, on peut attendre un peu ou vérifier
         std::cout << "[INFO] Flux téléphone ouvert avec succès.\n";
     }
+    else if (!rawPath.empty()) {
+        std::cout << "[INFO] Lecture enregistrement brut: " << rawPath << std::endl;
+        auto raw = std::make_unique<io::RawVideoSource>(rawPath);
+        std::cout << "[INFO] " << raw->reader().frameCount() << " images "
+                  << raw->reader().size().width << "x" << raw->reader().size().height << "\n";
+        source = std::move(raw);
+    }
     else {
         // [VIDEO CLASSIQUE]
         std::cout << "[INFO] Lecture fichier video: " << videoPath << std::endl;
@@ -116,16 +209,43 @@ int main(int argc, char** argv) {
         }
     }
 
-    // --- Chargement calibration ---
-    const ar::Calibration calib = ar::loadCalibration(calibPath);
-
     // --- Lecture de la première frame ---
-    cv::Mat frameBGR;
-    if (!cap.read(frameBGR) || frameBGR.empty()) {
+    if (useWebcam && mjpegRaw && !source) {
+      if (io::enableRawMjpeg(cap)) {
+        source = std::make_unique<io::MjpegCaptureSource>(cap, lumaDenom);
+        std::cout << "[INFO] MJPEG brut, décodage "
+                  << (io::MjpegDecoder::hasTurbo() ? "libjpeg-turbo" : "cv::imdecode") << "\n";
+      } else {
+        std::cerr << "[WARN] --mjpeg-raw ignoré : la webcam n'est pas en MJPG\n";
+      }
+    }
+    if (!source) source = std::make_unique<io::VideoCaptureSource>(cap);
+
+    io::Frame frame;
+    if (!source->read(frame)) {
       std::cerr << "Erreur : première frame vide !\n";
       return -1;
     }
-    int vw = frameBGR.cols, vh = frameBGR.rows;
+    int vw = frame.size().width, vh = frame.size().height;
+
+    // --- Chargement calibration (cache binaire pour cette résolution, sinon YAML) ---
+    const ar::PreparedCalibration prepared = ar::loadCalibrationCached(calibPath, {vw, vh}, undistort);
+    const ar::Calibration& calib = prepared.calib;
+    std::cout << "[INFO] Calibration " << (prepared.fromCache ? "depuis le cache" : "depuis le YAML") << "\n";
+    if (prepared.nativeSize.area() > 0 && prepared.nativeSize != prepared.imageSize)
+      std::cout << "[INFO] K mise à l'échelle " << prepared.nativeSize.width << "x" << prepared.nativeSize.height
+                << " -> " << vw << "x" << vh << "\n";
+    // Image redressée : plus de distorsion à modéliser dans solvePnP
+    const cv::Mat pnpDist = undistort ? cv::Mat() : calib.distCoeffs;
+    cv::Mat undistorted;
+
+    // --- Source live : thread de capture, on traite toujours la dernière image ---
+    // (un fichier vidéo reste lu image par image, sans perte)
+    std::unique_ptr<io::LatestFrameGrabber> grabber;
+    if ((useWebcam || usePhone) && !syncCapture) {
+      grabber = std::make_unique<io::LatestFrameGrabber>(*source);
+      grabber->start();
+    }
 
     // --- Initialisation GLFW + fenêtre ---
     if (!glfwInit()) return -1;
@@ -137,6 +257,22 @@ int main(int argc, char** argv) {
   #endif
     GLFWwindow* window = glfwCreateWindow(vw, vh, "ARCube", nullptr, nullptr);
     if (!window) { glfwTerminate(); return -1; }
+    // Fermé en dernier : toutes les poignées GL déclarées après sont détruites avant le contexte
+    struct GlfwWindowGuard {
+      GLFWwindow* w;
+      ~GlfwWindowGuard() {
+        // Les poignées sont détruites : ce qui reste au registre est une fuite
+        const glx::GpuStats left = glx::ResourceRegistry::instance().stats();
+        std::size_t count = 0;
+        for (std::size_t n : left.count) count += n;
+        if (count > 0) {
+          std::cerr << "[WARN] Ressources GPU encore vivantes à la fermeture : ";
+          glx::ResourceRegistry::instance().report(std::cerr);
+        }
+        glfwDestroyWindow(w);
+        glfwTerminate();
+      }
+    } windowGuard{window};
     glfwMakeContextCurrent(window); glfwSwapInterval(1);
 
     glewExperimental = GL_TRUE;
@@ -144,85 +280,74 @@ int main(int argc, char** argv) {
     glGetError(); // Ignore l'erreur générée par glewInit
 
     // --- Shaders ---
-    GLuint bgVS = glx::compile(GL_VERTEX_SHADER,   glx::BG_VS);
-    GLuint bgFS = glx::compile(GL_FRAGMENT_SHADER, glx::BG_FS);
-    GLuint bgProgram = glx::link({ bgVS, bgFS });
-    glDeleteShader(bgVS); glDeleteShader(bgFS);
-
-    GLuint lineVS = glx::compile(GL_VERTEX_SHADER,   glx::LINE_VS);
-    GLuint lineGS = glx::compile(GL_GEOMETRY_SHADER, glx::LINE_GS);
-    GLuint lineFS = glx::compile(GL_FRAGMENT_SHADER, glx::LINE_FS);
-    GLuint lineProgram = glx::link({ lineVS, lineGS, lineFS });
-    glDeleteShader(lineVS); glDeleteShader(lineGS); glDeleteShader(lineFS);
-
-    GLuint solidVS = glx::compile(GL_VERTEX_SHADER, glx::SOLID_VS);
-    GLuint solidFS = glx::compile(GL_FRAGMENT_SHADER, glx::SOLID_FS);
-    GLuint solidProgram = glx::link({solidVS, solidFS});
-    glDeleteShader(solidVS);
-    glDeleteShader(solidFS);
+    // Variantes d'une même source, binaires liés relus depuis le cache disque
+    glx::ShaderManager shaders;
+    glx::ProgramHandle bgProgram(shaders.build({glx::BG_VS, nullptr, glx::BG_FS}));
+    // Lignes de débogage : quads instanciés, sans geometry shader
+    glx::ProgramHandle lineProgram(shaders.build({glx::LINE_INST_VS, nullptr, glx::LINE_FS}));
+    // Couleur unie : murs (opaques) et ombre (semi-transparente)
+    glx::ProgramHandle flatProgram(shaders.build({glx::MESH_VS, nullptr, glx::MESH_FS}));
+    // Eclairage Phong (lumière + texture) : balle et sol VR
+    glx::ProgramHandle phongProgram(shaders.build({glx::MESH_VS, nullptr, glx::MESH_FS},
+                                                  glx::VARIANT_TEXTURED | glx::VARIANT_LIT));
+    // Imposteurs : balle (sphère lancée de rayons) et ombre (disque flou sur Z = 0)
+    glx::ProgramHandle impostorProgram, blobProgram;
+    if (impostors) {
+        impostorProgram.reset(shaders.build({glx::BALL_IMPOSTOR_VS, nullptr, glx::BALL_IMPOSTOR_FS}));
+        blobProgram.reset(shaders.build({glx::BLOB_SHADOW_VS, nullptr, glx::BLOB_SHADOW_FS}));
+    }
+    std::cout << "[INFO] Shaders : " << shaders.stats().cacheHits << " depuis le cache, "
+              << shaders.stats().compiled << " compilés (" << shaders.stats().ms << " ms)\n";
 
     // --- Meshes (quad fond, cube, axes) ---
-    glx::Mesh bg   = glx::createBackgroundQuad();
+    glx::MeshHandle bg(glx::createBackgroundQuad());
     // glx::Mesh cube = glx::createCubeWireframe(30.0f);
-    glx::Axes axes = glx::createAxes(210.0f);
-    // petite croix pour représenter la balle
-    glx::Axes ballAxes = glx::createAxes(10.f);
 
-    // === murs sur les bords A4 ===
-   // On élargit un peu le cadre pour que les coins se croisent
-    // Au lieu de 105 et 148.5, on pousse un peu plus loin
-    float extX = 105.0f + 6.0f;  // + demi-épaisseur
-    float extY = 148.5f + 6.0f; 
-
-    // === MURS CADRE A4 (Assemblage "Menuisier") ===
-    
-    // 1. D'ABORD, on calcule les dimensions
-    // Les murs Verticaux sont "LONGS" : ils vont jusqu'à 148.5 + 5mm = 153.5
-    float longY = 148.5f + 5.0f; 
-
-    // Les murs Horizontaux sont "COURTS" : ils s'arrêtent à 105 - 5mm = 100
-    float shortX = 105.0f - 5.0f;
-
-    // 2. ENSUITE, on crée le vecteur avec les valeurs calculées
-    std::vector<std::array<float,4>> wallSegments = {
-        // --- Murs Verticaux (Gauche & Droite) ---
-        // Ils font toute la hauteur + l'épaisseur des coins
-        {-105.f, -longY, -105.f, +longY}, // Gauche
-        {+105.f, -longY, +105.f, +longY}, // Droite
-
-        // --- Murs Horizontaux (Haut & Bas) ---
-        // Ils sont plus courts pour s'insérer entre les verticaux
-        {-shortX, +148.5f, +shortX, +148.5f}, // Haut
-        {-shortX, -148.5f, +shortX, -148.5f}  // Bas
-    };
+    // === murs sur les bords A4 (cadre "menuisier", cf. ar::a4FrameWalls) ===
+    const std::vector<std::array<float,4>> wallSegments = ar::a4FrameWalls();
 
     // hauteur du mur = 40 mm par exemple
     float WALL_HEIGHT = 40.f;
 
-    // création d’un seul mesh contenant tous les murs
-    float WALL_THICKNESS = 10.0f; // 1 cm d'épaisseur
-    glx::Mesh wallsMesh = glx::createWalls(wallSegments, WALL_HEIGHT, WALL_THICKNESS);
-
-    // 2. L'objet FIL DE FER (pour le noir) -> C'est cette ligne qui te manque !
-    glx::Mesh wallsWireframe = glx::createWallsWireframe(wallSegments, WALL_HEIGHT, WALL_THICKNESS);
+    // création d’un seul mesh contenant tous les murs (un VBO, faces pleines) ;
+    // les contours passent par les lignes de débogage
+    const float WALL_THICKNESS = ar::A4_WALL_THICKNESS;
+    glx::WallMesh walls = glx::createWallMesh(wallSegments, WALL_HEIGHT, WALL_THICKNESS);
+    glx::MeshHandle wallsOwner(walls.mesh);
+
+    // === Lignes de débogage : un seul draw ===
+    // Statiques : axes (X rouge, Y vert, Z bleu), contour de la feuille, arêtes des murs
+    glx::LineBatch debugLines;
+    debugLines.add({0,0,0}, {210.f,0,0}, {1,0,0}, 3.0f);
+    debugLines.add({0,0,0}, {0,210.f,0}, {0,1,0}, 3.0f);
+    debugLines.add({0,0,0}, {0,0,210.f}, {0,0,1}, 3.0f);
+    debugLines.addPolyline({{-105.f,-148.5f,0.f}, {105.f,-148.5f,0.f}, {105.f,148.5f,0.f}, {-105.f,148.5f,0.f}},
+                           true, {0.f, 0.8f, 1.f}, 1.5f);
+    debugLines.addPairs(walls.edgePoints, {0,0,0}, 1.0f);
+    debugLines.markStatic();
+    // Dynamique : trajectoire récente de la balle
+    std::deque<glm::vec3> ballTrail;
+    const std::size_t TRAIL_LEN = 90;
     // --- Texture pour la frame vidéo ---
     cv::Mat frameRGBA;
-    cv::cvtColor(frameBGR, frameRGBA, cv::COLOR_BGR2RGBA);
-    GLuint bgTex = glx::createTextureRGBA(frameRGBA.cols, frameRGBA.rows);
+    io::toRGBA(frame, frameRGBA);
+    glx::TextureHandle bgTex(glx::createTextureRGBA(frameRGBA.cols, frameRGBA.rows));
+
+    glx::RenderQueue renderQueue;  // états GL posés par execute()
 
-    glEnable(GL_DEPTH_TEST);
-    glClearColor(0.05f, 0.05f, 0.06f, 1.0f);
+    // Couche 3D rendue hors écran à une échelle réglée sur le budget, puis composée sur le fond
+    glx::OffscreenTarget overlay;
+    glx::GpuTimer overlayTimer;
+    glx::ResolutionController resolution(renderBudgetMs,
+                                          std::min(100, std::max(10, renderScaleMin)) / 100.0f);
 
     // --- Uniforms pour les shaders ---
-    GLint bg_uTex         = glGetUniformLocation(bgProgram,   "uTex");
-    GLint line_uMVP       = glGetUniformLocation(lineProgram, "uMVP");
-    GLint line_uColor     = glGetUniformLocation(lineProgram, "uColor");
-    GLint line_uThickness = glGetUniformLocation(lineProgram, "uThicknessPx");
-    GLint line_uViewport  = glGetUniformLocation(lineProgram, "uViewport");
-    const float THICKNESS_PX = 3.0f;
+    GLint bg_uTex         = glGetUniformLocation(bgProgram.get(),   "uTex");
+    GLint line_uMVP       = glGetUniformLocation(lineProgram.get(), "uMVP");
+    GLint line_uViewport  = glGetUniformLocation(lineProgram.get(), "uViewport");
 
-    GLint solid_uMVP   = glGetUniformLocation(solidProgram, "uMVP");
-    GLint solid_uColor = glGetUniformLocation(solidProgram, "uColor");
+    GLint flat_uMVP   = glGetUniformLocation(flatProgram.get(), "uMVP");
+    GLint flat_uColor = glGetUniformLocation(flatProgram.get(), "uColor");
 
     // --- Coordonnées 3D de la feuille A4 ---
     const float W = 210.f, H = 297.f;
@@ -234,35 +359,45 @@ int main(int argc, char** argv) {
     };
 
     cv::Mat rvec, tvec; // Rotation et translation
+    detect::A4Tracker tracker; // Suivi des coins A4 d'une frame à l'autre
     // =========================
     // BALLE (état logique)
     // =========================
     glm::vec3 ballPos(0.f, 0.f, 8.f);   // Position initiale
     glm::vec3 ballVel(0.f);             // Vitesse
     float ballRadius = 8.f;             // Rayon
-    // 1. Charger le Shader de Texture et les ombres
-
-    // Shader éclairage Phong (lumière + texture)
-    GLuint phongProgram = glx::link({glx::compile(GL_VERTEX_SHADER, glx::PHONG_VS), glx::compile(GL_FRAGMENT_SHADER, glx::PHONG_FS)});
-    GLint ph_uMVP = glGetUniformLocation(phongProgram, "uMVP");
-    GLint ph_uModel = glGetUniformLocation(phongProgram, "uModel");
-    GLint ph_uViewPos = glGetUniformLocation(phongProgram, "uViewPos");
-    GLint ph_uLightPos = glGetUniformLocation(phongProgram, "uLightPos");
-    GLint ph_uLightColor = glGetUniformLocation(phongProgram, "uLightColor");
-    GLint ph_uTex = glGetUniformLocation(phongProgram, "uTex");
-
-    // Shader ombres simples
-    GLuint shadowProgram = glx::link({glx::compile(GL_VERTEX_SHADER, glx::SHADOW_VS), glx::compile(GL_FRAGMENT_SHADER, glx::SHADOW_FS)});
-    GLint sh_uMVP = glGetUniformLocation(shadowProgram, "uMVP");
-    GLint sh_uColor = glGetUniformLocation(shadowProgram, "uColor");
-    // 2. Créer la sphère
-    glx::Mesh ballMesh = glx::createSphere(ballRadius, 32, 32);
+
+    GLint ph_uMVP = glGetUniformLocation(phongProgram.get(), "uMVP");
+    GLint ph_uModel = glGetUniformLocation(phongProgram.get(), "uModel");
+    GLint ph_uNormalMatrix = glGetUniformLocation(phongProgram.get(), "uNormalMatrix");
+    GLint ph_uViewPos = glGetUniformLocation(phongProgram.get(), "uViewPos");
+    GLint ph_uLightPos = glGetUniformLocation(phongProgram.get(), "uLightPos");
+    GLint ph_uLightColor = glGetUniformLocation(phongProgram.get(), "uLightColor");
+    GLint ph_uTex = glGetUniformLocation(phongProgram.get(), "uTex");
+
+    // 2. Créer la sphère : 4 niveaux de détail partagés via le cache
+    glx::MeshCache meshCache;
+    const glx::SphereLOD ballLOD = glx::createSphereLOD(meshCache, ballRadius);
+    const float focalPx = (float)calib.cameraMatrix.at<double>(1,1);
+
+    // Mode imposteurs : instances des balles et uniforms
+    glx::BallBatch ballBatch;
+    // (programmes absents hors mode imposteurs : locations -1, ignorées par la file)
+    auto optLoc = [](GLuint prog, const char* name) { return prog ? glGetUniformLocation(prog, name) : -1; };
+    GLint imp_uView       = optLoc(impostorProgram.get(), "uView");
+    GLint imp_uProj       = optLoc(impostorProgram.get(), "uProj");
+    GLint imp_uLightPosVS = optLoc(impostorProgram.get(), "uLightPosVS");
+    GLint imp_uLightColor = optLoc(impostorProgram.get(), "uLightColor");
+    GLint imp_uTex        = optLoc(impostorProgram.get(), "uTex");
+    GLint blob_uViewProj  = optLoc(blobProgram.get(), "uViewProj");
+    GLint blob_uLightPos  = optLoc(blobProgram.get(), "uLightPos");
+    GLint blob_uColor     = optLoc(blobProgram.get(), "uColor");
 
     // 3. Charger l'image de la balle
     cv::Mat ballImg = cv::imread("../data/balle.png"); 
     if (ballImg.empty()) std::cout << "ERREUR: Image balle introuvable !" << std::endl;
     else cv::cvtColor(ballImg, ballImg, cv::COLOR_BGR2RGB); // BGR -> RGB
-    GLuint ballTextureID = glx::createTextureFromMat(ballImg);
+    glx::TextureHandle ballTexture(glx::createTextureFromMat(ballImg));
 
     // --- 4. CHARGEMENT DES TEXTURES ADDITIONNELLES ---
 
@@ -270,7 +405,7 @@ int main(int argc, char** argv) {
     cv::Mat grassImg = cv::imread("../data/sol.png");
     if(grassImg.empty()) std::cerr << "ERREUR: Pelouse introuvable !" << std::endl;
     else cv::cvtColor(grassImg, grassImg, cv::COLOR_BGR2RGB);
-    GLuint grassTexID = glx::createTextureFromMat(grassImg);
+    glx::TextureHandle grassTex(glx::createTextureFromMat(grassImg));
 
     // B. Ciel VR (Skybox)
     cv::Mat skyImg = cv::imread("../data/ciel.jpeg");
@@ -281,10 +416,10 @@ int main(int argc, char** argv) {
       cv::flip(skyImg, skyImg, 0); 
     }
 
-    GLuint skyTexID = glx::createTextureFromMat(skyImg);
+    glx::TextureHandle skyTex(glx::createTextureFromMat(skyImg));
 
-    // D. Mesh pour le sol en VR (Un simple rectangle)
-    glx::Mesh floorMesh = glx::createBackgroundQuad();
+    // D. Mesh pour le sol en VR : rectangle de la taille de la feuille, avec normales
+    glx::MeshHandle floorMesh(glx::createFloorQuad(105.f, 148.5f));
     // =========================
     
     // Matrice qui stocke la rotation accumulée
@@ -298,32 +433,101 @@ int main(int argc, char** argv) {
       bool isVR = false;          // Par défaut on est en AR
       bool lastVPressed = false;  // Pour éviter que ça clignote si on reste appuyé
 
+    // Contrôleur de qualité (vision, physique, rendu) et état du suivi seul
+    ar::QualityController quality(targetFps, &std::cout);
+    cv::Mat grayFull, detLuma, prevDetLuma;
+    long frameIndex = 0;
+
+    // Scène fixe : dernier résultat de détection, réutilisé tant que rien ne bouge
+    detect::MotionGateConfig gateCfg;
+    gateCfg.refreshInterval = motionRefresh;
+    detect::MotionGate motionGate(gateCfg);
+    std::vector<cv::Point2f> lastPts;
+    bool lastOk = false;
+
+    // Latence capture -> traitement (horodatage noyau pour V4L2)
+    double latencySum = 0.0;
+    long latencyCount = 0;
+
+    // Source live en retard (caméra figée, flux réseau lent) : la fenêtre reste
+    // ouverte et réactive ; seule la fin du flux ou la fermeture arrête la boucle
+    auto nextFrame = [&]() {
+      if (!grabber) return source->read(frame);
+      while (!glfwWindowShouldClose(window)) {
+        if (grabber->waitLatest(frame, 100)) return true;
+        if (grabber->finished()) return false;
+        glfwPollEvents();
+      }
+      return false;
+    };
+
     // === BOUCLE PRINCIPALE ===
     while (!glfwWindowShouldClose(window)) {
-      if (!cap.read(frameBGR) || frameBGR.empty()) break;
+      if (!nextFrame()) break;
+
+      latencySum += io::monotonicSeconds() - frame.timestamp;
+      ++latencyCount;
+
+      if (undistort) {
+          // Remap BGR via les LUT ; la luminance réduite éventuelle n'est plus valable.
+          // undistorted reste à la boucle : frame.bgr peut être une vue en lecture seule
+          // sur la source (mmap .arv), jamais réutilisée comme destination
+          cv::remap(io::ensureBGR(frame), undistorted, prepared.undistMap1, prepared.undistMap2, cv::INTER_LINEAR);
+          if (!frame.bgr.u) frame.bgr = cv::Mat();   // vue non possédée : détachée, pas écrite
+          undistorted.copyTo(frame.bgr);
+          frame.format = io::PixelFormat::BGR;
+          frame.luma.release();
+      }
 
-      std::vector<cv::Point2f> imagePts;
-      bool okDetect = detect::detectA4Corners(frameBGR, imagePts);
+      const ar::QualitySettings& q = quality.settings();
+      const double tVision = io::monotonicSeconds();
 
-      if (!okDetect) {
-          // AFFICHER LE MESSAGE SI PAS DE DETECTION
-          std::string msg = "Pas de A4 detecte ! Placez la feuille...";
-          int baseline = 0;
-          cv::Size textSize = cv::getTextSize(msg, cv::FONT_HERSHEY_SIMPLEX, 1.0, 2, &baseline);
-          
-          // Centrer le texte
-          cv::Point textOrg((frameBGR.cols - textSize.width) / 2, (frameBGR.rows + textSize.height) / 2);
-          
-          // Fond noir semi-transparent pour lisibilité
-          cv::rectangle(frameBGR, textOrg + cv::Point(0, baseline), textOrg + cv::Point(textSize.width, -textSize.height), cv::Scalar(0,0,0), -1);
-          // Texte blanc
-          cv::putText(frameBGR, msg, textOrg, cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 255, 255), 2);
+      // Luminance de détection à 1/q.detectDenom : celle fournie par la source
+      // (V4L2, MJPEG réduit) si elle suffit, sinon réduite ici
+      int detDenom = frame.lumaDenom;
+      if (!frame.luma.empty() && frame.lumaDenom >= q.detectDenom) {
+          detLuma = frame.luma;
       } else {
-          
-          // On utilise les points potentiellement tournés pour que le tracking reste stable
-          cv::solvePnP(objectPts, imagePts, calib.cameraMatrix, calib.distCoeffs,
-                      rvec, tvec, !rvec.empty(), cv::SOLVEPNP_ITERATIVE);
+          const cv::Mat* src = &frame.luma;
+          int srcDenom = frame.lumaDenom;
+          if (frame.luma.empty()) {
+              cv::cvtColor(io::ensureBGR(frame), grayFull, cv::COLOR_BGR2GRAY);
+              src = &grayFull;
+              srcDenom = 1;
+          }
+          detDenom = std::max(q.detectDenom, srcDenom);
+          const int f = detDenom / srcDenom;
+          if (f > 1) cv::resize(*src, detLuma, cv::Size(src->cols / f, src->rows / f), 0, 0, cv::INTER_AREA);
+          else       detLuma = *src;
+      }
+
+      std::vector<cv::Point2f> imagePts;
+      bool okDetect;
+      // Rien n'a bougé dans et autour de la feuille : coins et pose inchangés
+      if (motionGate.isStatic(detLuma, detDenom, lastOk ? lastPts : std::vector<cv::Point2f>())) {
+          imagePts = lastPts;
+          okDetect = lastOk;
+      } else {
+          // Détection complète une image sur q.detectInterval ; entre-temps, suivi
+          // des coins par flux optique (redétection si le suivi échoue)
+          const bool fullDetect = frameIndex++ % q.detectInterval == 0 || prevDetLuma.size() != detLuma.size();
+          okDetect = !fullDetect && tracker.track(prevDetLuma, detLuma, imagePts, detDenom);
+          if (!okDetect) okDetect = tracker.detectLuma(detLuma, imagePts, detDenom);
+          if (q.detectInterval > 1) detLuma.copyTo(prevDetLuma);   // la source peut réutiliser son tampon
+          else                      prevDetLuma.release();
+
+          if (okDetect) {
+              
+              // On utilise les points potentiellement tournés pour que le tracking reste stable
+              cv::solvePnP(objectPts, imagePts, calib.cameraMatrix, pnpDist,
+                          rvec, tvec, !rvec.empty(), cv::SOLVEPNP_ITERATIVE);
+          }
+          lastPts = imagePts;
+          lastOk = okDetect;
       }
+      const double tPhysics = io::monotonicSeconds();
+      quality.record(ar::Stage::Vision, 1000.0 * (tPhysics - tVision));
+
       // =========================
       // PHYSIQUE BALLE
       // =========================
@@ -333,23 +537,46 @@ int main(int argc, char** argv) {
       if (dt > 0.05f) dt = 0.05f;
 
       if (okDetect && !rvec.empty()) {
-          // Une seule ligne pour tout gérer !
-          ar::updatePhysics(rvec, dt, ballPos, ballVel, ballRotationMatrix, 
-                            ballRadius, wallSegments, WALL_THICKNESS);
+          // Sous-pas : collisions plus sûres quand le budget le permet
+          const int substeps = q.physicsSubsteps;
+          for (int k = 0; k < substeps; ++k)
+              ar::updatePhysics(rvec, dt / substeps, ballPos, ballVel, ballRotationMatrix,
+                                ballRadius, wallSegments, WALL_THICKNESS);
+          ballTrail.push_back(ballPos);
+          if (ballTrail.size() > TRAIL_LEN) ballTrail.pop_front();
+      }
+
+      const double tRender = io::monotonicSeconds();
+      quality.record(ar::Stage::Physics, 1000.0 * (tRender - tPhysics));
+
+      // Conversion (directement depuis YUV pour V4L2)
+      io::toRGBA(frame, frameRGBA);
+
+      if (!okDetect) {
+          // AFFICHER LE MESSAGE SI PAS DE DETECTION (dessiné sur l'image RGBA)
+          std::string msg = "Pas de A4 detecte ! Placez la feuille...";
+          int baseline = 0;
+          cv::Size textSize = cv::getTextSize(msg, cv::FONT_HERSHEY_SIMPLEX, 1.0, 2, &baseline);
+          
+          // Centrer le texte
+          cv::Point textOrg((frameRGBA.cols - textSize.width) / 2, (frameRGBA.rows + textSize.height) / 2);
+          
+          // Fond noir semi-transparent pour lisibilité
+          cv::rectangle(frameRGBA, textOrg + cv::Point(0, baseline), textOrg + cv::Point(textSize.width, -textSize.height), cv::Scalar(0,0,0,255), -1);
+          // Texte jaune (ordre RGBA)
+          cv::putText(frameRGBA, msg, textOrg, cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(255, 255, 0, 255), 2);
       }
 
-      // Conversion + flip (OpenGL en bas à gauche)
-      cv::cvtColor(frameBGR, frameRGBA, cv::COLOR_BGR2RGBA);
+      // Flip (OpenGL en bas à gauche)
       cv::flip(frameRGBA, frameRGBA, 0);
 
       // Resize si résolution change (webcam)
       static int texW = frameRGBA.cols, texH = frameRGBA.rows;
       if (frameRGBA.cols != texW || frameRGBA.rows != texH) {
-        glDeleteTextures(1, &bgTex);
-        bgTex = glx::createTextureRGBA(frameRGBA.cols, frameRGBA.rows);
+        bgTex.reset(glx::createTextureRGBA(frameRGBA.cols, frameRGBA.rows));
         texW = frameRGBA.cols; texH = frameRGBA.rows;
       }
-      glx::updateTextureRGBA(bgTex, frameRGBA);
+      glx::updateTextureRGBA(bgTex.get(), frameRGBA);
 
       // === RENDU OPENGL ===
       glfwPollEvents();
@@ -364,185 +591,179 @@ int main(int argc, char** argv) {
 
       int fbw, fbh;
       glfwGetFramebufferSize(window, &fbw, &fbh);
-      glViewport(0, 0, fbw, fbh);
-      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+      // Résolution de la couche 3D d'après le temps GPU de l'image précédente
+      double overlayMs = 0.0;
+      if (overlayTimer.poll(overlayMs) && resolution.update(overlayMs))
+          std::cout << "[INFO] Couche 3D : échelle " << resolution.scale() << " (moyenne "
+                    << resolution.averageMs() << " ms, budget " << resolution.budgetMs() << " ms)\n";
+      overlay.resize(std::max(1, (int)std::lround(fbw * resolution.scale())),
+                     std::max(1, (int)std::lround(fbh * resolution.scale())));
 
       // --- Calcul des matrices ---
-      glm::mat4 P = ar::projectionFromCV(calib.cameraMatrix, (float)fbw, (float)fbh, 0.1f, 2000.0f);
+      // Coefficients normalisés par la taille de l'image : indépendants du framebuffer (HiDPI, redimensionnement)
+      glm::mat4 P = ar::projectionFromNDC(prepared.ndc, 0.1f, 2000.0f);
       glm::mat4 V = ar::viewFromRvecTvec(rvec, tvec);
 
       // Position caméra (extraction de la 4ème colonne de la matrice inverse de vue)
       glm::vec3 camPos = glm::vec3(glm::inverse(V)[3]);
 
-      // --- 1. GESTION DU FOND (AR ou VR) ---
-      glDisable(GL_DEPTH_TEST); // Le fond est derrière tout
-      glUseProgram(bgProgram);
-      glActiveTexture(GL_TEXTURE0);
+      // Les passes soumettent leurs draws à la file, qui les trie par état
+      // (couche, états fixes, programme, texture, VAO) avant exécution.
+      renderQueue.clear();
+      const glm::mat4 PV = P * V;
+      const glm::vec3 lightColor(2.0f); // Lumière blanche
 
-      if (!isVR) {
-          // === MODE AR : On dessine la webcam ===
-          glBindTexture(GL_TEXTURE_2D, bgTex);
-      } 
-      else {
-          // === MODE VR : On dessine le CIEL ===
-          // (On affiche la texture Skybox)
-          glBindTexture(GL_TEXTURE_2D, skyTexID); 
-      }
+      // --- 1. GESTION DU FOND (AR : webcam, VR : ciel) ---
+      // Sans test de profondeur (donc sans écriture) : pas besoin d'effacer le depth buffer ensuite
+      renderQueue.drawArrays(glx::Layer::Background, bgProgram.get(), bg->vao, GL_TRIANGLES, bg->count)
+        .setTexture(isVR ? skyTex.get() : bgTex.get())
+        .set(bg_uTex, 0);
 
-      glUniform1i(bg_uTex, 0);
-      glBindVertexArray(bg.vao);
-      glDrawArrays(GL_TRIANGLES, 0, bg.count);
-      glBindVertexArray(0);
-      
-      // On nettoie le depth buffer pour dessiner la 3D par dessus le fond
-      glClear(GL_DEPTH_BUFFER_BIT); 
-      glEnable(GL_DEPTH_TEST);
-      
       // ==========================================
       // B. SOL PELOUSE (Uniquement en VR)
       // ==========================================
       if (isVR) {
-          glUseProgram(phongProgram);
-          // La feuille fait 210x297. Le quad fait 2x2.
-          glm::mat4 M_floor = glm::scale(glm::mat4(1.0f), glm::vec3(105.f, 148.5f, 1.f));
-          
-          glUniformMatrix4fv(ph_uMVP, 1, GL_FALSE, glm::value_ptr(P * V * M_floor));
-          glUniformMatrix4fv(ph_uModel, 1, GL_FALSE, glm::value_ptr(M_floor));
-          glUniform3fv(ph_uViewPos, 1, glm::value_ptr(camPos));
-          glUniform3fv(ph_uLightPos, 1, glm::value_ptr(lightPos));
-          glUniform3fv(ph_uLightColor, 1, glm::value_ptr(glm::vec3(2.0f)));
-
-          glActiveTexture(GL_TEXTURE0);
-          glBindTexture(GL_TEXTURE_2D, grassTexID); // pelouse 
-          glUniform1i(ph_uTex, 0);
-          
-
-          glBindVertexArray(floorMesh.vao);
-          glDrawArrays(GL_TRIANGLES, 0, floorMesh.count);
+          // Le quad est déjà dans le repère de la feuille : matrices modèle et normale identité
+          const glm::mat4 M_floor(1.0f);
+          renderQueue.drawArrays(glx::Layer::Opaque, phongProgram.get(), floorMesh->vao, GL_TRIANGLES, floorMesh->count)
+            .setTexture(grassTex.get()) // pelouse
+            .set(ph_uMVP, PV)
+            .set(ph_uModel, M_floor)
+            .set(ph_uNormalMatrix, glm::mat3(1.0f))
+            .set(ph_uViewPos, camPos)
+            .set(ph_uLightPos, lightPos)
+            .set(ph_uLightColor, lightColor)
+            .set(ph_uTex, 0);
       }
 
-      // --- 2. Cube et axes ---
-      glEnable(GL_DEPTH_TEST);
-      glm::mat4 M_axes = glm::mat4(1.0f);
-      glm::mat4 M_cube = glm::translate(glm::mat4(1.0f), glm::vec3(0.f, 0.f, 30.f));
+     // === MURS ===
+      // Faces pleines (marron) avec un petit décalage pour ne pas masquer les contours
+      // (dessinés avec les lignes de débogage)
+      renderQueue.drawElements(glx::Layer::Opaque, flatProgram.get(), walls.mesh.vao, GL_TRIANGLES,
+                               walls.triangles.count, walls.indexType, walls.triangles.offset)
+        .setPolygonOffset(true)
+        .set(flat_uMVP, PV)
+        .set(flat_uColor, glm::vec4(0.6f, 0.3f, 0.2f, 1.0f));
+
+      // === BALLE ===
+      if (impostors) {
+          // Un quad par balle ; l'ombre réutilise les mêmes instances
+          ballBatch.clear();
+          ballBatch.add(ballPos, ballRadius, ballRotationMatrix);
+          ballBatch.upload();
+
+          renderQueue.drawArrays(glx::Layer::Transparent, blobProgram.get(), ballBatch.vao(), GL_TRIANGLE_STRIP, 4)
+            .setInstances(ballBatch.count())
+            .set(blob_uViewProj, PV)
+            .set(blob_uLightPos, lightPos)
+            .set(blob_uColor, glm::vec4(0.1f, 0.1f, 0.1f, 0.5f)); // Noir transparent
+
+          renderQueue.drawArrays(glx::Layer::Opaque, impostorProgram.get(), ballBatch.vao(), GL_TRIANGLE_STRIP, 4)
+            .setInstances(ballBatch.count())
+            .setTexture(ballTexture.get())
+            .set(imp_uView, V)
+            .set(imp_uProj, P)
+            .set(imp_uLightPosVS, glm::vec3(V * glm::vec4(lightPos, 1.0f)))
+            .set(imp_uLightColor, lightColor)
+            .set(imp_uTex, 0);
+      } else {
+          glm::mat4 M_ball = glm::translate(glm::mat4(1.f), ballPos) * ballRotationMatrix;
+
+          // Niveau de détail selon la taille de la balle à l'écran
+          const int ballLevel = ballLOD.select(glm::length(camPos - ballPos), focalPx);
+          const glx::Mesh& ballMesh = ballLOD.mesh(ballLevel);
+          // L'ombre (aplatie, semi-transparente) se contente d'un niveau de moins
+          const glx::Mesh& shadowMesh = ballLOD.mesh(std::max(0, ballLevel - 1));
+
+          // 1. OMBRE - Projection sur le sol (Z=0) selon la lumière (Directionnelle)
+          glm::mat4 shadowProj(1.0f);
+          shadowProj[2][0] = -lightPos.x / lightPos.z;
+          shadowProj[2][1] = -lightPos.y / lightPos.z;
+          shadowProj[2][2] = 0.0f;
+          glm::mat4 M_shadow = glm::translate(glm::mat4(1.0f), glm::vec3(0,0,0.1f)) * shadowProj * M_ball;
+
+          renderQueue.drawElements(glx::Layer::Transparent, flatProgram.get(), shadowMesh.vao, GL_TRIANGLES,
+                                   shadowMesh.count, GL_UNSIGNED_INT)
+            .set(flat_uMVP, PV * M_shadow)
+            .set(flat_uColor, glm::vec4(0.1f, 0.1f, 0.1f, 0.5f)); // Noir transparent
+
+          // 2. BALLE (Phong) - Eclairage Réaliste
+          renderQueue.drawElements(glx::Layer::Opaque, phongProgram.get(), ballMesh.vao, GL_TRIANGLES,
+                                   ballMesh.count, GL_UNSIGNED_INT)
+            .setTexture(ballTexture.get())
+            .set(ph_uMVP, PV * M_ball)
+            .set(ph_uModel, M_ball)
+            .set(ph_uNormalMatrix, glx::normalMatrix(M_ball))
+            .set(ph_uViewPos, camPos)
+            .set(ph_uLightPos, lightPos)
+            .set(ph_uLightColor, lightColor)
+            .set(ph_uTex, 0);
 
-      glUseProgram(lineProgram);
-      glUniform2f(line_uViewport, (float)fbw, (float)fbh);
-      glUniform1f(line_uThickness, THICKNESS_PX);
+      }
 
-     // === MURS ===
+      // === LIGNES DE DÉBOGAGE === (axes, contour, arêtes des murs, trajectoire : un seul draw)
+      debugLines.clear();
+      for (std::size_t i = 1; i < ballTrail.size(); ++i)
+          debugLines.add(ballTrail[i - 1], ballTrail[i], {1.f, 0.9f, 0.2f}, 1.5f);
+      debugLines.upload();
+      renderQueue.drawArrays(glx::Layer::Opaque, lineProgram.get(), debugLines.vao(), GL_TRIANGLE_STRIP, 4)
+        .setInstances(debugLines.count())
+        .set(line_uMVP, PV)
+        .set(line_uViewport, glm::vec2((float)fbw, (float)fbh));
+
+      // Fond à pleine résolution
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      glViewport(0, 0, fbw, fbh);
+      glClearColor(0.05f, 0.05f, 0.06f, 1.0f);
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      renderQueue.execute(glx::Layer::Background, glx::Layer::Background);
 
-      // 1. DESSIN SOLIDE (MARRON)
-      glUseProgram(solidProgram);
-      glm::mat4 M_walls = glm::mat4(1.0f);
-      glm::mat4 MVP_walls = P * V * M_walls;
-
-      glUniformMatrix4fv(solid_uMVP, 1, GL_FALSE, glm::value_ptr(MVP_walls));
-      glUniform3f(solid_uColor, 0.6f, 0.3f, 0.2f); // Marron
-      
-      // Petit décalage pour éviter que le marron ne cache les traits noirs
-      glEnable(GL_POLYGON_OFFSET_FILL);
-      glPolygonOffset(1.0f, 1.0f);
-      
-      glBindVertexArray(wallsMesh.vao);
-      glDrawElements(GL_TRIANGLES, wallsMesh.count, GL_UNSIGNED_INT, 0);
-      glDisable(GL_POLYGON_OFFSET_FILL);
-
-      // 2. DESSIN CONTOURS (NOIR) - SANS DIAGONALES
-      // On utilise "solidProgram" en mettant la couleur noire
-      glUniform3f(solid_uColor, 0.0f, 0.0f, 0.0f); // Noir pur
-      
-      glBindVertexArray(wallsWireframe.vao);
-      // ATTENTION : Ici on dessine des LIGNES (GL_LINES), pas des triangles !
-      glDrawElements(GL_LINES, wallsWireframe.count, GL_UNSIGNED_INT, 0);
-      
-      glBindVertexArray(0);
+      // Couche 3D hors écran (fond transparent, alpha prémultiplié)
+      overlay.bind();
+      glClearColor(0.f, 0.f, 0.f, 0.f);
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      overlayTimer.begin();
+      renderQueue.execute(glx::Layer::Opaque, glx::Layer::Transparent);
+      overlayTimer.end();
 
-      // === BALLE ===      
-      // ==========================================
-      // 1. OMBRE (Shadow) - Projection sur le sol
-      // ==========================================
+      // Composition : mise à l'échelle bilinéaire sur le fond
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      glViewport(0, 0, fbw, fbh);
+      glDisable(GL_DEPTH_TEST);
       glEnable(GL_BLEND);
-      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-      glUseProgram(shadowProgram);
-
-      // Matrice de projection sur le sol (Z=0) selon la lumière (Directionnelle)
-      glm::mat4 shadowProj(1.0f);
-      shadowProj[2][0] = -lightPos.x / lightPos.z;
-      shadowProj[2][1] = -lightPos.y / lightPos.z;
-      shadowProj[2][2] = 0.0f;
-
-      glm::mat4 M_ball_world = glm::translate(glm::mat4(1.0f), ballPos) * ballRotationMatrix;
-      
-      glm::mat4 M_shadow = glm::translate(glm::mat4(1.0f), glm::vec3(0,0,0.1f)) * shadowProj * M_ball_world;
-
-      glUniformMatrix4fv(sh_uMVP, 1, GL_FALSE, glm::value_ptr(P * V * M_shadow));
-      glUniform4f(sh_uColor, 0.1f, 0.1f, 0.1f, 0.5f); // Noir transparent
-      
-      glBindVertexArray(ballMesh.vao);
-      glDrawElements(GL_TRIANGLES, ballMesh.count, GL_UNSIGNED_INT, 0);
-      glDisable(GL_BLEND);
-
-      // ==========================================
-      // 2. BALLE (Phong) - Eclairage Réaliste
-      // ==========================================
-      glUseProgram(phongProgram); 
-      glm::mat4 M_ball = glm::translate(glm::mat4(1.f), ballPos) * ballRotationMatrix;
-      
-      glUniformMatrix4fv(ph_uMVP, 1, GL_FALSE, glm::value_ptr(P * V * M_ball));
-      glUniformMatrix4fv(ph_uModel, 1, GL_FALSE, glm::value_ptr(M_ball));
-      
-      // Lumière et Caméra
-      glUniform3fv(ph_uViewPos, 1, glm::value_ptr(camPos));
-      glUniform3fv(ph_uLightPos, 1, glm::value_ptr(lightPos));
-      glUniform3fv(ph_uLightColor, 1, glm::value_ptr(glm::vec3(2.0f))); // Lumière blanche
-
-      // Texture
+      glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+      glUseProgram(bgProgram.get());
       glActiveTexture(GL_TEXTURE0);
-      glBindTexture(GL_TEXTURE_2D, ballTextureID);
-      glUniform1i(ph_uTex, 0);
-
-      glBindVertexArray(ballMesh.vao);
-      glDrawElements(GL_TRIANGLES, ballMesh.count, GL_UNSIGNED_INT, 0);
-      // === AXES ===
-      glUseProgram(lineProgram);
-      glm::mat4 MVP_axes = P * V;
-      glUniformMatrix4fv(line_uMVP, 1, GL_FALSE, glm::value_ptr(MVP_axes));
- 
-      // Axe X — rouge
-      glUniform3f(line_uColor, 1.f, 0.f, 0.f);
-      glBindVertexArray(axes.x.vao);
-      glDrawArrays(GL_LINES, 0, axes.x.count);
-
-      // Axe Y — vert
-      glUniform3f(line_uColor, 0.f, 1.f, 0.f);
-      glBindVertexArray(axes.y.vao);
-      glDrawArrays(GL_LINES, 0, axes.y.count);
-
-      // Axe Z — bleu
-      glUniform3f(line_uColor, 0.f, 0.f, 1.f);
-      glBindVertexArray(axes.z.vao);
-      glDrawArrays(GL_LINES, 0, axes.z.count);
-
+      glBindTexture(GL_TEXTURE_2D, overlay.colorTexture());
+      glUniform1i(bg_uTex, 0);
+      glBindVertexArray(bg->vao);
+      glDrawArrays(GL_TRIANGLES, 0, bg->count);
       glBindVertexArray(0);
+      glDisable(GL_BLEND);
+
+      // Temps CPU du rendu (hors attente de la synchro verticale)
+      quality.record(ar::Stage::Render, 1000.0 * (io::monotonicSeconds() - tRender));
+      if (quality.endFrame()) resolution.setMaxScale(quality.settings().renderScaleMax);
 
-      // glm::mat4 MVP_cube = P * V * M_cube;
-      // glUniformMatrix4fv(line_uMVP, 1, GL_FALSE, glm::value_ptr(MVP_cube));
-      // glUniform3f(line_uColor, 0.f, 0.f, 0.f);
-      // glBindVertexArray(cube.vao);
-      // glDrawElements(GL_LINES, cube.count, GL_UNSIGNED_INT, 0);
-      // glBindVertexArray(0);
-      
       glfwSwapBuffers(window);
     }
 
-    // --- Nettoyage des ressources ---
-    glDeleteTextures(1, &grassTexID);
-    glDeleteTextures(1, &skyTexID);
-    glDeleteVertexArrays(1, &floorMesh.vao); glDeleteBuffers(1, &floorMesh.vbo);
-
-    // --- Nettoyage OpenGL ---
-    glx::cleanup(bgProgram, lineProgram, solidProgram, phongProgram, shadowProgram, bgTex, ballTextureID, bg, wallsMesh, ballMesh, axes, window);
+    // --- Arrêt de la capture ---
+    if (grabber) {
+      grabber->stop();
+      const io::GrabberStats st = grabber->stats();
+      std::cout << "[INFO] Capture : " << st.captured << " images lues, "
+                << st.delivered << " traitées, " << st.dropped << " abandonnées\n";
+    }
+    if (latencyCount > 0)
+      std::cout << "[INFO] Latence moyenne capture -> traitement : "
+                << 1000.0 * latencySum / latencyCount << " ms\n";
+    if (motionGate.totalFrames() > 0)
+      std::cout << "[INFO] Scène fixe : " << motionGate.skippedFrames() << "/" << motionGate.totalFrames()
+                << " images sans détection\n";
+
+    // --- Nettoyage : poignées RAII (ressources GL) puis windowGuard (contexte, bilan des fuites) ---
     return 0;
     
   } catch (const std::exception& e) {
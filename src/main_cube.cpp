@@ -11,7 +11,7 @@
 #include "glx/mesh.hpp"           // Création des maillages 3D
 #include "glx/shaders.hpp"        // Compilation / linkage des shaders
 #include "glx/texture.hpp"        // Gestion de la texture
-#include "glx/cleanup.hpp"        // Nettoyage à la fin
+#include "glx/resource.hpp"       // Poignées RAII des objets GL
 
 #include <iostream>
 #include <stdexcept>
@@ -107,6 +107,11 @@ int main(int argc, char** argv) {
   #endif
     GLFWwindow* window = glfwCreateWindow(vw, vh, "ARCube", nullptr, nullptr);
     if (!window) { glfwTerminate(); return -1; }
+    // Fermé en dernier : toutes les poignées GL déclarées après sont détruites avant le contexte
+    struct GlfwWindowGuard {
+      GLFWwindow* w;
+      ~GlfwWindowGuard() { glfwDestroyWindow(w); glfwTerminate(); }
+    } windowGuard{window};
     glfwMakeContextCurrent(window); glfwSwapInterval(1);
 
     glewExperimental = GL_TRUE;
@@ -116,34 +121,35 @@ int main(int argc, char** argv) {
     // --- Shaders ---
     GLuint bgVS = glx::compile(GL_VERTEX_SHADER,   glx::BG_VS);
     GLuint bgFS = glx::compile(GL_FRAGMENT_SHADER, glx::BG_FS);
-    GLuint bgProgram = glx::link({ bgVS, bgFS });
+    glx::ProgramHandle bgProgram(glx::link({ bgVS, bgFS }));
     glDeleteShader(bgVS); glDeleteShader(bgFS);
 
     GLuint lineVS = glx::compile(GL_VERTEX_SHADER,   glx::LINE_VS);
     GLuint lineGS = glx::compile(GL_GEOMETRY_SHADER, glx::LINE_GS);
     GLuint lineFS = glx::compile(GL_FRAGMENT_SHADER, glx::LINE_FS);
-    GLuint lineProgram = glx::link({ lineVS, lineGS, lineFS });
+    glx::ProgramHandle lineProgram(glx::link({ lineVS, lineGS, lineFS }));
     glDeleteShader(lineVS); glDeleteShader(lineGS); glDeleteShader(lineFS);
 
     // --- Meshes (quad fond, cube, axes) ---
-    glx::Mesh bg   = glx::createBackgroundQuad();
-    glx::Mesh cube = glx::createCubeWireframe(30.0f);
-    glx::Axes axes = glx::createAxes(210.0f);
+    glx::MeshHandle bg(glx::createBackgroundQuad());
+    glx::MeshHandle cube(glx::createCubeWireframe(30.0f));
+    const glx::Axes axes = glx::createAxes(210.0f);
+    glx::MeshHandle axisX(axes.x), axisY(axes.y), axisZ(axes.z);
 
     // --- Texture pour la frame vidéo ---
     cv::Mat frameRGBA;
     cv::cvtColor(frameBGR, frameRGBA, cv::COLOR_BGR2RGBA);
-    GLuint bgTex = glx::createTextureRGBA(frameRGBA.cols, frameRGBA.rows);
+    glx::TextureHandle bgTex(glx::createTextureRGBA(frameRGBA.cols, frameRGBA.rows));
 
     glEnable(GL_DEPTH_TEST);
     glClearColor(0.05f, 0.05f, 0.06f, 1.0f);
 
     // --- Uniforms pour les shaders ---
-    GLint bg_uTex         = glGetUniformLocation(bgProgram,   "uTex");
-    GLint line_uMVP       = glGetUniformLocation(lineProgram, "uMVP");
-    GLint line_uColor     = glGetUniformLocation(lineProgram, "uColor");
-    GLint line_uThickness = glGetUniformLocation(lineProgram, "uThicknessPx");
-    GLint line_uViewport  = glGetUniformLocation(lineProgram, "uViewport");
+    GLint bg_uTex         = glGetUniformLocation(bgProgram.get(),   "uTex");
+    GLint line_uMVP       = glGetUniformLocation(lineProgram.get(), "uMVP");
+    GLint line_uColor     = glGetUniformLocation(lineProgram.get(), "uColor");
+    GLint line_uThickness = glGetUniformLocation(lineProgram.get(), "uThicknessPx");
+    GLint line_uViewport  = glGetUniformLocation(lineProgram.get(), "uViewport");
     const float THICKNESS_PX = 3.0f;
 
     // --- Coordonnées 3D de la feuille A4 ---
@@ -176,11 +182,10 @@ int main(int argc, char** argv) {
       // Resize si résolution change (webcam)
       static int texW = frameRGBA.cols, texH = frameRGBA.rows;
       if (frameRGBA.cols != texW || frameRGBA.rows != texH) {
-        glDeleteTextures(1, &bgTex);
-        bgTex = glx::createTextureRGBA(frameRGBA.cols, frameRGBA.rows);
+        bgTex.reset(glx::createTextureRGBA(frameRGBA.cols, frameRGBA.rows));
         texW = frameRGBA.cols; texH = frameRGBA.rows;
       }
-      glx::updateTextureRGBA(bgTex, frameRGBA);
+      glx::updateTextureRGBA(bgTex.get(), frameRGBA);
 
       // === RENDU OPENGL ===
       glfwPollEvents();
@@ -191,12 +196,12 @@ int main(int argc, char** argv) {
 
       // --- 1. Fond vidéo ---
       glDisable(GL_DEPTH_TEST);
-      glUseProgram(bgProgram);
+      glUseProgram(bgProgram.get());
       glActiveTexture(GL_TEXTURE0);
-      glBindTexture(GL_TEXTURE_2D, bgTex);
+      glBindTexture(GL_TEXTURE_2D, bgTex.get());
       glUniform1i(bg_uTex, 0);
-      glBindVertexArray(bg.vao);
-      glDrawArrays(GL_TRIANGLES, 0, bg.count);
+      glBindVertexArray(bg->vao);
+      glDrawArrays(GL_TRIANGLES, 0, bg->count);
       glBindVertexArray(0);
 
       // --- 2. Cube et axes ---
@@ -206,7 +211,7 @@ int main(int argc, char** argv) {
       glm::mat4 M_axes = glm::mat4(1.0f);
       glm::mat4 M_cube = glm::translate(glm::mat4(1.0f), glm::vec3(0.f, 0.f, 30.f));
 
-      glUseProgram(lineProgram);
+      glUseProgram(lineProgram.get());
       glUniform2f(line_uViewport, (float)fbw, (float)fbh);
       glUniform1f(line_uThickness, THICKNESS_PX);
 
@@ -220,15 +225,14 @@ int main(int argc, char** argv) {
       glm::mat4 MVP_cube = P * V * M_cube;
       glUniformMatrix4fv(line_uMVP, 1, GL_FALSE, glm::value_ptr(MVP_cube));
       glUniform3f(line_uColor, 0.f, 0.f, 0.f);
-      glBindVertexArray(cube.vao);
-      glDrawElements(GL_LINES, cube.count, GL_UNSIGNED_INT, 0);
+      glBindVertexArray(cube->vao);
+      glDrawElements(GL_LINES, cube->count, GL_UNSIGNED_INT, 0);
       glBindVertexArray(0);
 
       glfwSwapBuffers(window);
     }
 
-    // --- Nettoyage OpenGL ---
-    glx::cleanup(bgProgram, lineProgram, bgTex, bg, cube, axes, window);
+    // --- Nettoyage : poignées RAII (ressources GL) puis windowGuard (contexte) ---
     return 0;
 
   } catch (const std::exception& e) {
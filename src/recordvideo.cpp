@@ -1,15 +1,23 @@
 // record_cam_gui.cpp
 // Webcam + enregistrement vidéo avec BOUTONS CLIQUABLES (Start/Stop REC, Snapshot).
 // Enregistre automatiquement dans ../data/ (ou ./data/ en fallback).
+// --raw : enregistrement brut sans perte (.arv, relu par AR_A4_Video --raw), --lz4 pour compresser.
 // Ubuntu / OpenCV 4, backend V4L2. Touche q/ESC pour quitter.
 
 #include <opencv2/opencv.hpp>
+#include "io/rawvideo.hpp"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
 #include <sstream>
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -64,6 +72,122 @@ static bool tryOpenCam(int cam, int W, int H, int FPS, cv::VideoCapture& cap) {
     return false;
 }
 
+// ---------- Encodeur asynchrone ----------
+// La capture ne doit jamais attendre l'encodeur (mp4v est coûteux en CPU) :
+// les images passent par une file bornée de tampons pré-alloués, encodés par
+// un thread dédié. Si la file est pleine, l'image est abandonnée (et comptée)
+// plutôt que de bloquer la boucle caméra.
+class AsyncVideoWriter {
+public:
+    struct Stats {
+        long queued = 0;    // images acceptées dans la file
+        long written = 0;   // images encodées
+        long dropped = 0;   // images refusées (file pleine)
+        int  maxDepth = 0;  // profondeur max observée de la file
+    };
+
+    ~AsyncVideoWriter() { close(); }
+
+    bool open(const std::string& path, int fourcc, double fps, cv::Size size, int poolSize = 8) {
+        close();
+        if (!writer_.open(path, fourcc, fps, size)) return false;
+        start(size, poolSize);
+        return true;
+    }
+
+    // Variante brute sans perte (io::RawVideoWriter) : pas d'encodage, juste des écritures alignées.
+    bool openRaw(const std::string& path, double fps, cv::Size size, bool lz4, int poolSize = 8) {
+        close();
+        if (!raw_.open(path, size, CV_8UC3, fps, lz4)) return false;
+        start(size, poolSize);
+        return true;
+    }
+
+    // Ne bloque jamais : copie dans un tampon libre ou abandonne l'image.
+    void push(const cv::Mat& frame, double timestamp) {
+        int slot;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            if (!thread_.joinable()) return;
+            if (free_.empty()) { ++stats_.dropped; return; }
+            slot = free_.front(); free_.pop_front();
+        }
+        frame.copyTo(pool_[slot]); // même taille/type : pas de réallocation
+        stamps_[slot] = timestamp;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            pending_.push_back(slot);
+            ++stats_.queued;
+            stats_.maxDepth = std::max(stats_.maxDepth, (int)pending_.size());
+        }
+        cv_.notify_one();
+    }
+
+    // Vide la file puis ferme le fichier.
+    void close() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        if (thread_.joinable()) thread_.join();
+        writer_.release();
+        raw_.close();
+    }
+
+    bool isOpen() const { return thread_.joinable(); }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return stats_;
+    }
+
+private:
+    void start(cv::Size size, int poolSize) {
+        // Pool de tampons alloués une fois pour toutes (pas de clone par image)
+        pool_.assign(poolSize, cv::Mat());
+        stamps_.assign(poolSize, 0.0);
+        free_.clear(); pending_.clear();
+        for (int i = 0; i < poolSize; ++i) {
+            pool_[i].create(size, CV_8UC3);
+            free_.push_back(i);
+        }
+        stats_ = Stats{};
+        stop_ = false;
+        thread_ = std::thread(&AsyncVideoWriter::run, this);
+    }
+
+    void run() {
+        for (;;) {
+            int slot;
+            {
+                std::unique_lock<std::mutex> lk(m_);
+                cv_.wait(lk, [this] { return stop_ || !pending_.empty(); });
+                if (pending_.empty()) return; // stop_ et file vide
+                slot = pending_.front(); pending_.pop_front();
+            }
+            if (raw_.isOpened()) raw_.write(pool_[slot], stamps_[slot]);
+            else writer_.write(pool_[slot]);
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                free_.push_back(slot);
+                ++stats_.written;
+            }
+        }
+    }
+
+    cv::VideoWriter writer_;
+    io::RawVideoWriter raw_;
+    std::vector<cv::Mat> pool_;
+    std::vector<double> stamps_;
+    std::deque<int> free_, pending_;
+    Stats stats_;
+    bool stop_ = false;
+    mutable std::mutex m_;
+    std::condition_variable cv_;
+    std::thread thread_;
+};
+
 // ---------- UI boutons ----------
 struct Button {
     cv::Rect rect;
@@ -109,9 +233,21 @@ static void drawRECdot(cv::Mat& img, bool rec) {
 int main(int argc, char** argv) {
     int camIndex = 0;
     int reqW = 1280, reqH = 720, reqFPS = 30;
-    if (argc >= 2) try { camIndex = std::stoi(argv[1]); } catch(...) {}
-    if (argc >= 4) { try { reqW = std::stoi(argv[2]); reqH = std::stoi(argv[3]); } catch(...) {} }
-    if (argc >= 5) try { reqFPS = std::stoi(argv[4]); } catch(...) {}
+    bool rawMode = false, rawLz4 = false;
+
+    // options --raw / --lz4, le reste est positionnel : [cam] [W H] [FPS]
+    std::vector<std::string> pos;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--raw") rawMode = true;
+        else if (a == "--lz4") { rawMode = true; rawLz4 = true; }
+        else pos.push_back(a);
+    }
+    if (pos.size() >= 1) try { camIndex = std::stoi(pos[0]); } catch(...) {}
+    if (pos.size() >= 3) { try { reqW = std::stoi(pos[1]); reqH = std::stoi(pos[2]); } catch(...) {} }
+    if (pos.size() >= 4) try { reqFPS = std::stoi(pos[3]); } catch(...) {}
+    if (rawLz4 && !io::RawVideoWriter::hasLz4())
+        std::cerr << "[WARN] Built without LZ4, raw frames will be stored uncompressed\n";
 
     cv::VideoCapture cap;
     if (!tryOpenCam(camIndex, reqW, reqH, reqFPS, cap)) {
@@ -131,14 +267,22 @@ int main(int argc, char** argv) {
     cv::namedWindow(win, cv::WINDOW_AUTOSIZE);
     cv::setMouseCallback(win, onMouse, nullptr);
 
-    // writer lazy (créé au clic Start REC)
-    cv::VideoWriter writer;
+    // writer lazy (créé au clic Start REC), encodage sur son propre thread
+    AsyncVideoWriter writer;
     bool isRecording = false;
     int fourcc_mp4v = cv::VideoWriter::fourcc('m','p','4','v'); // MP4 (MPEG-4 Part 2)
     int fourcc_mjpg = cv::VideoWriter::fourcc('M','J','P','G'); // AVI fallback
 
+    auto stopRecording = [&]() {
+        writer.close();
+        const AsyncVideoWriter::Stats st = writer.stats();
+        std::cout << "[OK] Recording stopped. " << st.written << " frames written, "
+                  << st.dropped << " dropped (queue full), max queue depth "
+                  << st.maxDepth << "\n";
+    };
+
+    cv::Mat frame; // réutilisé d'une image à l'autre (pas d'allocation par frame)
     while (true) {
-        cv::Mat frame;
         if (!cap.read(frame) || frame.empty()) {
             std::cerr << "[WARN] Empty frame. Stopping.\n";
             break;
@@ -146,8 +290,17 @@ int main(int argc, char** argv) {
 
         // --- UI input handling ---
         if (ui.wantToggleRec.exchange(false)) {
-            if (!isRecording) {
-                writer.release();
+            if (!isRecording && rawMode) {
+                fs::path outdir = pickDataDir();
+                std::string out = (outdir / timestamped("capture", ".arv")).string();
+                if (!writer.openRaw(out, FPS, cv::Size(W,H), rawLz4)) {
+                    std::cerr << "[ERR] Cannot open raw writer: " << out << "\n";
+                } else {
+                    std::cout << "[OK] Recording (raw" << (rawLz4 ? "+lz4" : "") << "): " << out << "\n";
+                    isRecording = true;
+                    ui.btnRec.label = "Stop REC";
+                }
+            } else if (!isRecording) {
                 fs::path outdir = pickDataDir();
                 std::string out = (outdir / timestamped("capture", ".mp4")).string();
                 if (!writer.open(out, fourcc_mp4v, FPS, cv::Size(W,H))) {
@@ -168,8 +321,7 @@ int main(int argc, char** argv) {
             } else {
                 isRecording = false;
                 ui.btnRec.label = "Start REC";
-                writer.release();
-                std::cout << "[OK] Recording stopped.\n";
+                stopRecording();
             }
         }
 
@@ -183,13 +335,14 @@ int main(int argc, char** argv) {
             }
         }
 
-        // --- write si enregistrement ---
-        if (isRecording && writer.isOpened()) {
-            writer.write(frame);
+        // --- envoi à l'encodeur (copie dans un tampon du pool, jamais bloquant) ---
+        if (isRecording && writer.isOpen()) {
+            writer.push(frame, std::chrono::duration<double>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
         }
 
-        // --- Dessin UI ---
-        cv::Mat display = frame.clone();
+        // --- Dessin UI (directement sur la frame : l'encodeur a déjà sa copie) ---
+        cv::Mat& display = frame;
         drawButton(display, ui.btnRec, isRecording);
         drawButton(display, ui.btnSnap, false);
         drawRECdot(display, isRecording);
@@ -206,7 +359,7 @@ int main(int argc, char** argv) {
     }
 
     cap.release();
-    if (writer.isOpened()) writer.release();
+    if (isRecording) stopRecording();
     cv::destroyAllWindows();
     return 0;
 }
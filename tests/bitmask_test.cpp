@@ -0,0 +1,93 @@
+// Test de detect::BitMask contre la référence OpenCV : seuillage, dilatation,
+// érosion et fermeture rectangulaires doivent donner exactement le même masque.
+// Compilé deux fois (SSE2 et AR_NO_SIMD), cf. CMakeLists.txt.
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include "detect/bitmask.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void expectSame(const cv::Mat& got, const cv::Mat& ref, const std::string& what) {
+  if (got.size() == ref.size() && cv::countNonZero(got != ref) == 0) return;
+  ++failures;
+  std::cerr << "[ECHEC] " << what << "\n";
+}
+
+static std::string describe(const std::string& op, const cv::Mat& m) {
+  return op + " " + std::to_string(m.cols) + "x" + std::to_string(m.rows);
+}
+
+static std::string describe(const std::string& op, const cv::Mat& m, cv::Size k) {
+  return describe(op, m) + " noyau " + std::to_string(k.width) + "x" + std::to_string(k.height);
+}
+
+int main() {
+  cv::RNG rng(0x41344134);
+  // Largeurs autour des frontières de mots de 64 bits
+  const int widths[] = {1, 2, 63, 64, 65, 127, 130, 200};
+  const int heights[] = {1, 7, 33};
+  const double thresholds[] = {-1, 0, 254, 255, 127.5, 40};
+
+  for (int w : widths)
+    for (int h : heights) {
+      cv::Mat gray(h, w, CV_8UC1);
+      rng.fill(gray, cv::RNG::UNIFORM, 0, 256);
+
+      // --- Seuillage ---
+      for (double t : thresholds) {
+        cv::Mat ref;
+        cv::threshold(gray, ref, t, 255, cv::THRESH_BINARY);
+        detect::BitMask bits;
+        detect::thresholdToBits(gray, t, bits);
+        expectSame(bits.toMat(), ref, describe("seuil " + std::to_string(t), gray));
+      }
+
+      // Masques de densités variées (taches et trous)
+      for (int density : {20, 50, 80}) {
+        cv::Mat noise(h, w, CV_8UC1), mask;
+        rng.fill(noise, cv::RNG::UNIFORM, 0, 100);
+        cv::threshold(noise, mask, density - 1, 255, cv::THRESH_BINARY_INV);
+        detect::BitMask bits;
+        detect::thresholdToBits(mask, 0, bits);
+        expectSame(bits.toMat(), mask, describe("conversion", mask));
+
+        // --- Noyaux pairs et impairs jusqu'à 9x9 ---
+        for (int kw = 1; kw <= 9; ++kw)
+          for (int kh = 1; kh <= 9; ++kh) {
+            const cv::Size k(kw, kh);
+            const cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, k);
+            cv::Mat ref;
+            detect::BitMask out;
+
+            cv::dilate(mask, ref, kernel);
+            detect::dilateRect(bits, out, k);
+            expectSame(out.toMat(), ref, describe("dilatation", mask, k));
+
+            cv::erode(mask, ref, kernel);
+            detect::erodeRect(bits, out, k);
+            expectSame(out.toMat(), ref, describe("érosion", mask, k));
+
+            cv::morphologyEx(mask, ref, cv::MORPH_CLOSE, kernel);
+            detect::closeRect(bits, out, k);
+            expectSame(out.toMat(), ref, describe("fermeture", mask, k));
+
+            // En place (dst == src), comme dans A4Tracker::detectLuma
+            detect::BitMask inPlace = bits;
+            detect::closeRect(inPlace, inPlace, k);
+            expectSame(inPlace.toMat(), ref, describe("fermeture en place", mask, k));
+          }
+      }
+    }
+
+  if (failures) {
+    std::cerr << failures << " échec(s)\n";
+    return 1;
+  }
+  std::cout << "bitmask_test : OK\n";
+  return 0;
+}